@@ -2,14 +2,17 @@
  * File: main.c
  * Brief: Control ECU main application (APP layer)
  * Target: TM4C123GH6PM
- * Clock: 16 MHz
+ * Clock: 80 MHz (PLL, see SYSCLK_HZ)
  *========================================================*/
 #include <stdint.h>
 #include "../Common/Std_Types.h"
 
+#include "../MCAL/Clock.h"
 #include "../MCAL/UART.h"
 #include "../MCAL/EEPROM.h"
 #include "../MCAL/delay.h"
+#include "../MCAL/Profile.h"
+#include "../MCAL/Kernel.h"
 
 #include "../HAL/Motor.h"
 #include "../HAL/RGB_LED.h"
@@ -19,6 +22,8 @@
 
 #define UART_BAUDRATE          (9600u)
 
+#define SYSCLK_HZ              (CLOCK_80MHZ)
+
 #define TIMEOUT_DEFAULT_SEC    (10u)
 #define TIMEOUT_MIN_SEC        (5u)
 #define TIMEOUT_MAX_SEC        (30u)
@@ -26,13 +31,48 @@
 #define BOOT_LED_MS            (300u)
 #define FEEDBACK_MS            (120u)
 #define SHORT_BLIP_MS          (80u)
-#define BLINK_MS               (250u)
+#define BREATHE_MS             (500u)
+
+/* ================== TASKS ==================
+   Link RX outranks everything, so a command (a lock request in the middle
+   of a 2 s open included) is picked up as soon as UART1_Handler posts
+   EV_LINK_RX, plus its own handler time. Slow work is handed down: motor moves and EEPROM writes
+   each run in their own lower-priority task; LED patterns play from the
+   RGB driver's timer ISR. */
+#define TASK_PRIO_LINK         (4u)
+#define TASK_PRIO_MOTOR        (3u)
+#define TASK_PRIO_EEPROM       (1u)
+
+#define LINK_STACK_WORDS       (256u)   /* handlers + dump line buffers */
+#define MOTOR_STACK_WORDS      (128u)
+#define EEPROM_STACK_WORDS     (128u)
+
+#define EV_LINK_RX             (1u << 0)
+#define EV_MOTOR_CMD           (1u << 0)
+#define EV_EEPROM_SYNC         (1u << 0)
+
+typedef enum
+{
+    MOTOR_CMD_STOP = 0,
+    MOTOR_CMD_OPEN,
+    MOTOR_CMD_CLOSE
+} MotorCmd;
 
 /* ================== STATE ================== */
 static char    g_password[PASSWORD_LENGTH] = { '1','2','3','4','5' };
 static uint8   g_timeout_seconds           = TIMEOUT_DEFAULT_SEC;
 static uint8   g_initialized               = 0u;
 
+static uint32 g_link_stack[LINK_STACK_WORDS];
+static uint32 g_motor_stack[MOTOR_STACK_WORDS];
+static uint32 g_eeprom_stack[EEPROM_STACK_WORDS];
+
+static Kernel_TaskId g_task_link;
+static Kernel_TaskId g_task_motor;
+static Kernel_TaskId g_task_eeprom;
+
+static volatile MotorCmd g_motor_cmd = MOTOR_CMD_STOP;
+
 /* ================== HELPERS ================== */
 static uint8 Password_Equals(const char *a, const char *b)
 {
@@ -60,6 +100,61 @@ static uint8 ClampTimeout(uint8 t)
     return t;
 }
 
+/* UART1 RX ISR context */
+static void Link_OnRx(void)
+{
+    Kernel_SetEvents(g_task_link, EV_LINK_RX);
+}
+
+/* Blocks only the link task until the RX ISR queues a byte */
+static uint8 Link_ReadByte(void)
+{
+    uint8 b;
+
+    while (UART1_TryReceiveByte(&b) != E_OK)
+    {
+        (void)Kernel_WaitEvents(EV_LINK_RX, KERNEL_WAIT_FOREVER);
+    }
+    return b;
+}
+
+/* Replaces whatever is showing and returns at once; ends on idle blue.
+   Link and motor tasks both call it, so one at a time. */
+static void Led_Play(RGB_PatternKind kind, RGB_Color_t color, uint16 period_ms, uint8 count)
+{
+    RGB_PatternType p;
+    uint32 cs;
+
+    p.kind      = kind;
+    p.color     = RGB_LED_ColorValue(color);
+    p.period_ms = period_ms;
+    p.count     = count;
+    p.rest      = RGB_LED_ColorValue(RGB_BLUE);
+
+    cs = Kernel_EnterCritical();
+    (void)RGB_LED_Play(&p);
+    Kernel_ExitCritical(cs);
+}
+
+/* count on phases of on_ms, separated by equal off phases */
+static void Led_Show(RGB_Color_t color, uint16 on_ms, uint8 count)
+{
+    Led_Play(RGB_PATTERN_BLINK, color, on_ms, count);
+}
+
+/* Latest command wins, even mid-move */
+static void Motor_Request(MotorCmd cmd)
+{
+    g_motor_cmd = cmd;
+    Kernel_SetEvents(g_task_motor, EV_MOTOR_CMD);
+}
+
+/* EEPROM task writes whatever the state is when it gets to run */
+static void Eeprom_RequestSync(void)
+{
+    Kernel_SetEvents(g_task_eeprom, EV_EEPROM_SYNC);
+}
+
 /* ================== COMMANDS ==================
    I : init flag (0/1)
    V : verify password -> Y/N
@@ -70,6 +165,8 @@ static uint8 ClampTimeout(uint8 t)
    G : get saved timeout -> sends one byte timeout (5..30)
    S : set timeout with password (atomic) -> K/N/E
        HMI sends: 'S' + 5 pass bytes + 2 ascii digits
+   P : diagnostics -> profiling and task stack tables as text lines
+       (not used by HMI)
 */
 static void Handle_I(void)
 {
@@ -83,21 +180,19 @@ static void Handle_V(void)
 
     for (i = 0u; i < PASSWORD_LENGTH; i++)
     {
-        entered[i] = (char)UART1_ReceiveByte();
+        entered[i] = (char)Link_ReadByte();
     }
 
     if ((g_initialized != 0u) && (Password_Equals(entered, g_password) != 0u))
     {
         UART1_SendByte((uint8)'Y');
-        RGB_LED_SetColor(RGB_GREEN);
+        Led_Show(RGB_GREEN, FEEDBACK_MS, 1u);
     }
     else
     {
         UART1_SendByte((uint8)'N');
-        RGB_LED_SetColor(RGB_RED);
+        Led_Show(RGB_RED, FEEDBACK_MS, 1u);
     }
-    Delay_ms(FEEDBACK_MS);
-    RGB_LED_SetColor(RGB_BLUE);
 }
 
 static void Handle_N(void)
@@ -107,19 +202,17 @@ static void Handle_N(void)
 
     for (i = 0u; i < PASSWORD_LENGTH; i++)
     {
-        new_pass[i] = (char)UART1_ReceiveByte();
+        new_pass[i] = (char)Link_ReadByte();
     }
 
     Password_Copy(g_password, new_pass);
     g_initialized = 1u;
 
-    EEPROM_Save(g_password, g_timeout_seconds, g_initialized);
+    Eeprom_RequestSync();
 
     UART1_SendByte((uint8)'K');
 
-    RGB_LED_SetColor(RGB_CYAN);
-    Delay_ms(FEEDBACK_MS);
-    RGB_LED_SetColor(RGB_BLUE);
+    Led_Show(RGB_CYAN, FEEDBACK_MS, 1u);
 }
 
 static void Handle_G(void)
@@ -139,19 +232,17 @@ static void Handle_S(void)
 
     for (i = 0u; i < PASSWORD_LENGTH; i++)
     {
-        entered[i] = (char)UART1_ReceiveByte();
+        entered[i] = (char)Link_ReadByte();
     }
 
-    b1 = UART1_ReceiveByte();
-    b2 = UART1_ReceiveByte();
+    b1 = Link_ReadByte();
+    b2 = Link_ReadByte();
 
     /* must be digits */
     if ((b1 < (uint8)'0') || (b1 > (uint8)'9') || (b2 < (uint8)'0') || (b2 > (uint8)'9'))
     {
         UART1_SendByte((uint8)'E');
-        RGB_LED_SetColor(RGB_RED);
-        Delay_ms(FEEDBACK_MS);
-        RGB_LED_SetColor(RGB_BLUE);
+        Led_Show(RGB_RED, FEEDBACK_MS, 1u);
         return;
     }
 
@@ -161,19 +252,15 @@ static void Handle_S(void)
     if ((g_initialized == 0u) || (Password_Equals(entered, g_password) == 0u))
     {
         UART1_SendByte((uint8)'N');
-        RGB_LED_SetColor(RGB_RED);
-        Delay_ms(FEEDBACK_MS);
-        RGB_LED_SetColor(RGB_BLUE);
+        Led_Show(RGB_RED, FEEDBACK_MS, 1u);
         return;
     }
 
     g_timeout_seconds = timeout;
-    EEPROM_Save(g_password, g_timeout_seconds, g_initialized);
+    Eeprom_RequestSync();
 
     UART1_SendByte((uint8)'K');
-    RGB_LED_SetColor(RGB_YELLOW);
-    Delay_ms(FEEDBACK_MS);
-    RGB_LED_SetColor(RGB_BLUE);
+    Led_Show(RGB_YELLOW, FEEDBACK_MS, 1u);
 }
 
 static void Handle_R(void)
@@ -181,50 +268,166 @@ static void Handle_R(void)
     g_initialized = 0u;
     g_timeout_seconds = TIMEOUT_DEFAULT_SEC;
 
-    Motor_Stop();
-    EEPROM_Clear();
+    Motor_Request(MOTOR_CMD_STOP);
+    Eeprom_RequestSync();       /* not initialized -> clears */
 
     UART1_SendByte((uint8)'K');
 
-    RGB_LED_SetColor(RGB_MAGENTA);
-    Delay_ms(BLINK_MS);
-    RGB_LED_SetColor(RGB_OFF);
-    Delay_ms(BLINK_MS);
-    RGB_LED_SetColor(RGB_MAGENTA);
-    Delay_ms(BLINK_MS);
-    RGB_LED_SetColor(RGB_BLUE);
+    Led_Play(RGB_PATTERN_BREATHE, RGB_MAGENTA, BREATHE_MS, 2u);
 }
 
 static void Handle_O(void)
 {
-    RGB_LED_SetColor(RGB_CYAN);
-    Motor_Open();
-    RGB_LED_SetColor(RGB_BLUE);
+    Motor_Request(MOTOR_CMD_OPEN);
 }
 
 static void Handle_L(void)
 {
-    RGB_LED_SetColor(RGB_YELLOW);
-    Motor_Close();
-    RGB_LED_SetColor(RGB_BLUE);
+    Motor_Request(MOTOR_CMD_CLOSE);
+}
+
+static void Handle_P(void)
+{
+    Profile_Dump(UART1_SendString);
+    Kernel_Dump(UART1_SendString);
 }
 
 static void Handle_Unknown(void)
 {
     UART1_SendByte((uint8)'?');
-    RGB_LED_SetColor(RGB_RED);
-    Delay_ms(SHORT_BLIP_MS);
-    RGB_LED_SetColor(RGB_BLUE);
+    Led_Show(RGB_RED, SHORT_BLIP_MS, 1u);
+}
+
+/* Handler zones include the blocking UART reads of the command payload */
+static Profile_ZoneId Cmd_ToZone(uint8 cmd)
+{
+    switch (cmd)
+    {
+        case (uint8)'I': return PROF_ZONE_CMD_INIT;
+        case (uint8)'V': return PROF_ZONE_CMD_VERIFY;
+        case (uint8)'N': return PROF_ZONE_CMD_NEWPASS;
+        case (uint8)'G': return PROF_ZONE_CMD_GETTIMEOUT;
+        case (uint8)'S': return PROF_ZONE_CMD_SETTIMEOUT;
+        case (uint8)'R': return PROF_ZONE_CMD_RESET;
+        case (uint8)'O': return PROF_ZONE_CMD_OPEN;
+        case (uint8)'L': return PROF_ZONE_CMD_LOCK;
+        case (uint8)'P': return PROF_ZONE_COUNT;    /* dump is not profiled */
+        default:         return PROF_ZONE_CMD_UNKNOWN;
+    }
+}
+
+/* ================== TASK BODIES ================== */
+static void Task_Link(void)
+{
+    /* Bytes that arrived before now are already in the ring */
+    UART1_SetRxNotify(Link_OnRx);
+
+    for (;;)
+    {
+        uint8 cmd = Link_ReadByte();
+        Profile_ZoneId zone = Cmd_ToZone(cmd);
+
+        PROFILE_BEGIN(zone);
+
+        switch (cmd)
+        {
+            case (uint8)'I': Handle_I(); break;
+            case (uint8)'V': Handle_V(); break;
+            case (uint8)'N': Handle_N(); break;
+            case (uint8)'G': Handle_G(); break;
+            case (uint8)'S': Handle_S(); break;
+            case (uint8)'R': Handle_R(); break;
+            case (uint8)'O': Handle_O(); break;
+            case (uint8)'L': Handle_L(); break;
+            case (uint8)'P': Handle_P(); break;
+            default:         Handle_Unknown(); break;
+        }
+
+        PROFILE_END(zone);
+    }
+}
+
+static void Task_Motor(void)
+{
+    uint32 pending = 0u;
+
+    for (;;)
+    {
+        MotorCmd cmd;
+
+        if (pending == 0u)
+        {
+            (void)Kernel_WaitEvents(EV_MOTOR_CMD, KERNEL_WAIT_FOREVER);
+        }
+
+        cmd = g_motor_cmd;
+        Motor_Stop();
+
+        if (cmd == MOTOR_CMD_STOP)
+        {
+            pending = 0u;
+            continue;
+        }
+
+        Led_Show((cmd == MOTOR_CMD_OPEN) ? RGB_CYAN : RGB_YELLOW,
+                 (uint16)(MOTOR_BRAKE_MS + MOTOR_RUN_MS), 1u);
+
+        /* Any new command during brake or run restarts from the top */
+        pending = Kernel_WaitEvents(EV_MOTOR_CMD, MOTOR_BRAKE_MS);
+        if (pending == 0u)
+        {
+            Motor_Drive((cmd == MOTOR_CMD_OPEN) ? MOTOR_DIR_OPEN : MOTOR_DIR_CLOSE);
+            pending = Kernel_WaitEvents(EV_MOTOR_CMD, MOTOR_RUN_MS);
+            if (pending == 0u)
+            {
+                Motor_Stop();
+            }
+        }
+    }
 }
 
-/* ================== MAIN ================== */
+static void Task_Eeprom(void)
+{
+    for (;;)
+    {
+        char pass[PASSWORD_LENGTH];
+        uint8 timeout;
+        uint8 init;
+        uint32 cs;
+
+        (void)Kernel_WaitEvents(EV_EEPROM_SYNC, KERNEL_WAIT_FOREVER);
+
+        /* Snapshot so the link task cannot change it mid-write */
+        cs = Kernel_EnterCritical();
+        Password_Copy(pass, g_password);
+        timeout = g_timeout_seconds;
+        init    = g_initialized;
+        Kernel_ExitCritical(cs);
+
+        if (init != 0u)
+        {
+            EEPROM_Save(pass, timeout, init);
+        }
+        else
+        {
+            EEPROM_Clear();
+        }
+    }
+}
+
+/* ================== MAIN ==================
+   Commands are answered before their side effects finish: 'K' for N/S/R
+   is sent once RAM is updated, and the EEPROM task persists it shortly
+   after. */
 int main(void)
 {
     uint8 init = 0u;
     uint8 t = TIMEOUT_DEFAULT_SEC;
     char pass[PASSWORD_LENGTH];
 
-    Delay_Init_16MHz();
+    (void)Clock_Init(SYSCLK_HZ);
+    Delay_Init();
+    Profile_Init();
     RGB_LED_Init();
     Motor_Init();
     UART1_Init(UART_BAUDRATE);
@@ -237,25 +440,22 @@ int main(void)
         g_initialized = (init != 0u) ? 1u : 0u;
     }
 
+    /* White, easing into idle blue while the tasks start */
     RGB_LED_SetColor(RGB_WHITE);
-    Delay_ms(BOOT_LED_MS);
-    RGB_LED_SetColor(RGB_BLUE);
+    Led_Play(RGB_PATTERN_FADE, RGB_BLUE, BOOT_LED_MS, 1u);
+
+    Kernel_Init();
+    (void)Kernel_CreateTask(Task_Link, TASK_PRIO_LINK, g_link_stack,
+                            LINK_STACK_WORDS, "Link", &g_task_link);
+    (void)Kernel_CreateTask(Task_Motor, TASK_PRIO_MOTOR, g_motor_stack,
+                            MOTOR_STACK_WORDS, "Motor", &g_task_motor);
+    (void)Kernel_CreateTask(Task_Eeprom, TASK_PRIO_EEPROM, g_eeprom_stack,
+                            EEPROM_STACK_WORDS, "EEPROM", &g_task_eeprom);
+
+    Kernel_Start();
 
     for (;;)
     {
-        uint8 cmd = UART1_ReceiveByte();
-
-        switch (cmd)
-        {
-            case (uint8)'I': Handle_I(); break;
-            case (uint8)'V': Handle_V(); break;
-            case (uint8)'N': Handle_N(); break;
-            case (uint8)'G': Handle_G(); break;
-            case (uint8)'S': Handle_S(); break;
-            case (uint8)'R': Handle_R(); break;
-            case (uint8)'O': Handle_O(); break;
-            case (uint8)'L': Handle_L(); break;
-            default:         Handle_Unknown(); break;
-        }
+        /* not reached */
     }
 }
@@ -16,10 +16,6 @@
 #define MOTOR_IN2_MASK               (1u << 3)  /* PB3 */
 #define MOTOR_PINS_MASK              (MOTOR_IN1_MASK | MOTOR_IN2_MASK)
 
-/* Tune this for your lock mechanics */
-#define MOTOR_RUN_MS                 (2000u)
-#define MOTOR_BRAKE_MS               (20u)       /* short stop between direction changes */
-
 void Motor_Init(void)
 {
     /* Enable clock for Port B */
@@ -45,15 +41,29 @@ void Motor_Stop(void)
     GPIO_PORTB_DATA_R &= ~MOTOR_PINS_MASK;
 }
 
+void Motor_Drive(Motor_Dir_t dir)
+{
+    if (dir == MOTOR_DIR_OPEN)
+    {
+        /* Direction: IN1=1, IN2=0 -> forward (unlock) */
+        GPIO_PORTB_DATA_R |=  MOTOR_IN1_MASK;
+        GPIO_PORTB_DATA_R &= ~MOTOR_IN2_MASK;
+    }
+    else
+    {
+        /* Direction: IN1=0, IN2=1 -> reverse (lock) */
+        GPIO_PORTB_DATA_R &= ~MOTOR_IN1_MASK;
+        GPIO_PORTB_DATA_R |=  MOTOR_IN2_MASK;
+    }
+}
+
 void Motor_Open(void)
 {
     /* Stop first to avoid shoot-through during direction change */
     Motor_Stop();
     Delay_ms(MOTOR_BRAKE_MS);
 
-    /* Direction: IN1=1, IN2=0 -> forward (unlock) */
-    GPIO_PORTB_DATA_R |=  MOTOR_IN1_MASK;
-    GPIO_PORTB_DATA_R &= ~MOTOR_IN2_MASK;
+    Motor_Drive(MOTOR_DIR_OPEN);
 
     Delay_ms(MOTOR_RUN_MS);
     Motor_Stop();
@@ -65,9 +75,7 @@ void Motor_Close(void)
     Motor_Stop();
     Delay_ms(MOTOR_BRAKE_MS);
 
-    /* Direction: IN1=0, IN2=1 -> reverse (lock) */
-    GPIO_PORTB_DATA_R &= ~MOTOR_IN1_MASK;
-    GPIO_PORTB_DATA_R |=  MOTOR_IN2_MASK;
+    Motor_Drive(MOTOR_DIR_CLOSE);
 
     Delay_ms(MOTOR_RUN_MS);
     Motor_Stop();
@@ -3,9 +3,23 @@
 
 #include <stdint.h>
 
+/* Tune these for your lock mechanics */
+#define MOTOR_RUN_MS                 (2000u)
+#define MOTOR_BRAKE_MS               (20u)       /* short stop between direction changes */
+
+typedef enum
+{
+    MOTOR_DIR_OPEN = 0,
+    MOTOR_DIR_CLOSE
+} Motor_Dir_t;
+
 void Motor_Init(void);
 void Motor_Open(void);    // rotate to "unlock" direction
 void Motor_Close(void);   // rotate to "lock" direction
 void Motor_Stop(void);
 
+/* Energise one direction and return; the caller brakes first and times
+ * the move, so it can be cut short by Motor_Stop() or a reversal */
+void Motor_Drive(Motor_Dir_t dir);
+
 #endif /* MOTOR_H_ */
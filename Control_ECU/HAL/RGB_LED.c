@@ -1,9 +1,16 @@
 #include "RGB_LED.h"
 #include "TM4C123GH6PM.h"
+#include "../MCAL/Clock.h"
 
 /* External RGB on Port C:
- * PC5 = Red, PC6 = Green, PC7 = Blue
+ * PC5 = Red   (WT0CCP1, WTIMER0 B)
+ * PC6 = Green (WT1CCP0, WTIMER1 A)
+ * PC7 = Blue  (WT1CCP1, WTIMER1 B)
  * Common cathode, ON = HIGH
+ *
+ * PC6/PC7 have no PWM module output, so all three use the wide timers in
+ * PWM mode. Fully off and fully on hand the pin back to GPIO, so those
+ * levels are exact and glitch-free. Timer0A steps the pattern engine.
  */
 
 #define RGB_RED_PIN     (1u << 5)   /* PC5 */
@@ -11,67 +18,345 @@
 #define RGB_BLUE_PIN    (1u << 7)   /* PC7 */
 #define RGB_ALL_PINS    (RGB_RED_PIN | RGB_GREEN_PIN | RGB_BLUE_PIN)
 
+#define RGB_PCTL_MASK   ((0xFu << 20) | (0xFu << 24) | (0xFu << 28))
+#define RGB_PCTL_WTCCP  ((0x7u << 20) | (0x7u << 24) | (0x7u << 28))
+
+/* GPIODATA alias: only the LED pins change, no read-modify-write */
+#define RGB_GPIOC_BASE              (0x40006000u)
+#define RGB_GPIO_DATA(mask)         (*((volatile uint32_t *)(RGB_GPIOC_BASE + ((uint32_t)(mask) << 2))))
+
 #define SYSCTL_RCGCGPIO_PORTC_MASK  (1u << 2)
+#define SYSCTL_RCGCWTIMER_WT0_MASK  (1u << 0)
+#define SYSCTL_RCGCWTIMER_WT1_MASK  (1u << 1)
+#define SYSCTL_RCGCTIMER_TIMER0_MASK (1u << 0)
+
+/* Split wide timers; count down, output high from reload to match. The
+ * match is taken at the next timeout, so a change never cuts a period. */
+#define TIMER_CFG_32BIT             (0x0u)
+#define WTIMER_CFG_SPLIT            (0x4u)
+#define TIMER_MR_PERIODIC           (0x2u)
+#define TIMER_MR_AMS                (1u << 3)
+#define TIMER_MR_MRSU               (1u << 10)
+#define TIMER_MR_PWM                (TIMER_MR_MRSU | TIMER_MR_AMS | TIMER_MR_PERIODIC)
+#define TIMER_CTL_TAEN_MASK         (1u << 0)
+#define TIMER_CTL_TBEN_MASK         (1u << 8)
+#define TIMER_TATO_MASK             (1u << 0)
+#define NVIC_EN0_TIMER0A_MASK       (1u << 19)  /* IRQ 19 */
+
+#define RGB_LEVEL_MAX               (255u)
+
+typedef enum
+{
+    RGB_CH_RED = 0,
+    RGB_CH_GREEN,
+    RGB_CH_BLUE
+} RGB_Channel;
+
+static uint32_t s_pwm_load = CLOCK_RESET_HZ / RGB_PWM_HZ;
+static RGB_ValueType s_now = { 0u, 0u, 0u };
+
+/* Owned by the tick ISR while s_playing */
+static RGB_PatternType s_pattern;
+static RGB_ValueType s_from;        /* FADE start */
+static uint32_t s_phase_ms = 0u;    /* into the current cycle */
+static uint8_t s_cycle = 0u;
+static volatile boolean s_playing = FALSE;
+
+static void RGB_LED_SetMatch(RGB_Channel ch, uint32_t match)
+{
+    switch (ch)
+    {
+        case RGB_CH_RED:   WTIMER0_TBMATCHR_R = match; break;
+        case RGB_CH_GREEN: WTIMER1_TAMATCHR_R = match; break;
+        default:           WTIMER1_TBMATCHR_R = match; break;
+    }
+}
+
+/* Gamma 2.0: duty = (level / 255)^2, close to the usual 2.2 without a
+ * table. Ends (and anything that rounds to them) are plain GPIO. */
+static void RGB_LED_Drive(RGB_Channel ch, uint32_t pin, uint8_t level)
+{
+    uint32_t high = 0u;
+
+    if (level == RGB_LEVEL_MAX)
+    {
+        high = s_pwm_load;
+    }
+    else
+    {
+        high = ((s_pwm_load / RGB_LEVEL_MAX) * level * level) / RGB_LEVEL_MAX;
+    }
+
+    if ((high == 0u) || (high >= s_pwm_load))
+    {
+        RGB_GPIO_DATA(pin) = (high == 0u) ? 0u : pin;
+        GPIO_PORTC_AFSEL_R &= ~pin;
+    }
+    else
+    {
+        RGB_LED_SetMatch(ch, s_pwm_load - high);
+        GPIO_PORTC_AFSEL_R |= pin;
+    }
+}
+
+static void RGB_LED_Show(RGB_ValueType value)
+{
+    s_now = value;
+    RGB_LED_Drive(RGB_CH_RED, RGB_RED_PIN, value.r);
+    RGB_LED_Drive(RGB_CH_GREEN, RGB_GREEN_PIN, value.g);
+    RGB_LED_Drive(RGB_CH_BLUE, RGB_BLUE_PIN, value.b);
+}
+
+/* num / den of the way from one level to the other, num <= den */
+static uint8_t RGB_LED_Mix(uint8_t from, uint8_t to, uint32_t num, uint32_t den)
+{
+    int32_t step = (((int32_t)to - (int32_t)from) * (int32_t)num) / (int32_t)den;
+
+    return (uint8_t)((int32_t)from + step);
+}
+
+static RGB_ValueType RGB_LED_Blend(RGB_ValueType from, RGB_ValueType to, uint32_t num, uint32_t den)
+{
+    RGB_ValueType v;
+
+    v.r = RGB_LED_Mix(from.r, to.r, num, den);
+    v.g = RGB_LED_Mix(from.g, to.g, num, den);
+    v.b = RGB_LED_Mix(from.b, to.b, num, den);
+    return v;
+}
+
+/* Tick stopped and any pending step dropped; the engine is idle after */
+static void RGB_LED_Halt(void)
+{
+    TIMER0_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+    TIMER0_ICR_R = TIMER_TATO_MASK;
+    NVIC_UNPEND0_R = NVIC_EN0_TIMER0A_MASK;
+    s_playing = FALSE;
+}
+
+static void RGB_LED_StartTick(uint32_t sysclk_hz)
+{
+    TIMER0_TAILR_R = ((sysclk_hz / 1000u) * RGB_TICK_MS) - 1u;
+    TIMER0_TAV_R = TIMER0_TAILR_R;
+    TIMER0_CTL_R |= TIMER_CTL_TAEN_MASK;
+}
+
+/* Frame for s_phase_ms; FALSE once the pattern is over */
+static boolean RGB_LED_Frame(RGB_ValueType *out)
+{
+    const RGB_ValueType off = { 0u, 0u, 0u };
+    const uint32_t period = s_pattern.period_ms;
+    const boolean last = ((s_pattern.count != 0u) && ((uint32_t)s_cycle + 1u >= s_pattern.count)) ? TRUE : FALSE;
+    uint32_t half;
+
+    switch (s_pattern.kind)
+    {
+        case RGB_PATTERN_BLINK:
+            if (s_phase_ms < period)
+            {
+                *out = s_pattern.color;
+                return TRUE;
+            }
+            *out = off;
+            return (last == TRUE) ? FALSE : TRUE;
+
+        case RGB_PATTERN_BREATHE:
+            half = period / 2u;
+            *out = (s_phase_ms < half) ? RGB_LED_Blend(off, s_pattern.color, s_phase_ms, half)
+                                       : RGB_LED_Blend(off, s_pattern.color, period - s_phase_ms, period - half);
+            return TRUE;
+
+        default:
+            *out = RGB_LED_Blend(s_from, s_pattern.color, s_phase_ms, period);
+            return TRUE;
+    }
+}
+
+/* Same PWM frequency, levels and tick period at the new rate */
+static void RGB_LED_OnClockChange(uint32_t sysclk_hz)
+{
+    s_pwm_load = sysclk_hz / RGB_PWM_HZ;
+    WTIMER0_TBILR_R = s_pwm_load;
+    WTIMER1_TAILR_R = s_pwm_load;
+    WTIMER1_TBILR_R = s_pwm_load;
+    RGB_LED_Show(s_now);
+
+    if (s_playing == TRUE)
+    {
+        TIMER0_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+        RGB_LED_StartTick(sysclk_hz);
+    }
+}
 
 void RGB_LED_Init(void)
 {
-    /* Enable Port C clock */
+    const RGB_ValueType off = { 0u, 0u, 0u };
+
     SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_PORTC_MASK;
+    SYSCTL_RCGCWTIMER_R |= (SYSCTL_RCGCWTIMER_WT0_MASK | SYSCTL_RCGCWTIMER_WT1_MASK);
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_TIMER0_MASK;
     (void)SYSCTL_RCGCGPIO_R;
+    (void)SYSCTL_RCGCWTIMER_R;
+    (void)SYSCTL_RCGCTIMER_R;
 
-    /* PC5, PC6, PC7 as digital outputs */
+    RGB_LED_Halt();
+
+    /* PC5..PC7 low GPIO outputs, muxed to the timers for in-between levels */
+    RGB_GPIO_DATA(RGB_ALL_PINS) = 0u;
     GPIO_PORTC_DIR_R |= RGB_ALL_PINS;
     GPIO_PORTC_DEN_R |= RGB_ALL_PINS;
-
-    /* Disable analog + alternate function for these pins (good practice) */
     GPIO_PORTC_AFSEL_R &= ~RGB_ALL_PINS;
     GPIO_PORTC_AMSEL_R &= ~RGB_ALL_PINS;
+    GPIO_PORTC_PCTL_R = (GPIO_PORTC_PCTL_R & ~RGB_PCTL_MASK) | RGB_PCTL_WTCCP;
+
+    /* WTIMER0 A (PC4) is unused; the split CFG covers both halves */
+    WTIMER0_CTL_R &= ~(TIMER_CTL_TAEN_MASK | TIMER_CTL_TBEN_MASK);
+    WTIMER1_CTL_R &= ~(TIMER_CTL_TAEN_MASK | TIMER_CTL_TBEN_MASK);
+    WTIMER0_CFG_R = WTIMER_CFG_SPLIT;
+    WTIMER1_CFG_R = WTIMER_CFG_SPLIT;
+    WTIMER0_TBMR_R = TIMER_MR_PWM;
+    WTIMER1_TAMR_R = TIMER_MR_PWM;
+    WTIMER1_TBMR_R = TIMER_MR_PWM;
+
+    s_pwm_load = Clock_GetSysClkHz() / RGB_PWM_HZ;
+    WTIMER0_TBILR_R = s_pwm_load;
+    WTIMER1_TAILR_R = s_pwm_load;
+    WTIMER1_TBILR_R = s_pwm_load;
+    WTIMER0_TBMATCHR_R = s_pwm_load;
+    WTIMER1_TAMATCHR_R = s_pwm_load;
+    WTIMER1_TBMATCHR_R = s_pwm_load;
+    WTIMER0_CTL_R |= TIMER_CTL_TBEN_MASK;
+    WTIMER1_CTL_R |= (TIMER_CTL_TAEN_MASK | TIMER_CTL_TBEN_MASK);
+
+    /* Timer0A: pattern tick, runs only while a pattern plays */
+    TIMER0_CFG_R = TIMER_CFG_32BIT;
+    TIMER0_TAMR_R = TIMER_MR_PERIODIC;
+    TIMER0_IMR_R |= TIMER_TATO_MASK;
 
-    /* PCTL for PC5-7 -> GPIO (clear fields) */
-    GPIO_PORTC_PCTL_R &= ~((0xFu << 20) | (0xFu << 24) | (0xFu << 28));
+    (void)Clock_RegisterListener(RGB_LED_OnClockChange);
 
-    /* All OFF initially */
-    GPIO_PORTC_DATA_R &= ~RGB_ALL_PINS;
+    RGB_LED_Show(off);
+
+    NVIC_EN0_R |= NVIC_EN0_TIMER0A_MASK;
 }
 
-void RGB_LED_SetColor(RGB_Color_t color)
+void TIMER0A_Handler(void)
 {
-    /* Turn OFF first */
-    GPIO_PORTC_DATA_R &= ~RGB_ALL_PINS;
+    RGB_ValueType v;
 
-    switch (color)
+    TIMER0_ICR_R = TIMER_TATO_MASK;
+
+    if (s_playing == FALSE)
     {
-        case RGB_RED:
-            GPIO_PORTC_DATA_R |= RGB_RED_PIN;
-            break;
+        return;
+    }
 
-        case RGB_GREEN:
-            GPIO_PORTC_DATA_R |= RGB_GREEN_PIN;
-            break;
+    s_phase_ms += RGB_TICK_MS;
 
-        case RGB_BLUE:
-            GPIO_PORTC_DATA_R |= RGB_BLUE_PIN;
-            break;
+    if (s_pattern.kind == RGB_PATTERN_FADE)
+    {
+        if (s_phase_ms >= s_pattern.period_ms)
+        {
+            RGB_LED_Halt();
+            RGB_LED_Show(s_pattern.color);
+            return;
+        }
+    }
+    else
+    {
+        const uint32_t cycle_ms = (s_pattern.kind == RGB_PATTERN_BLINK) ?
+                                  (2u * (uint32_t)s_pattern.period_ms) : s_pattern.period_ms;
 
-        case RGB_YELLOW:
-            GPIO_PORTC_DATA_R |= (RGB_RED_PIN | RGB_GREEN_PIN);
-            break;
+        if (s_phase_ms >= cycle_ms)
+        {
+            s_phase_ms -= cycle_ms;
+            if (s_cycle < 0xFFu) { s_cycle++; }
+        }
 
-        case RGB_CYAN:
-            GPIO_PORTC_DATA_R |= (RGB_GREEN_PIN | RGB_BLUE_PIN);
-            break;
+        if ((s_pattern.count != 0u) && (s_cycle >= s_pattern.count))
+        {
+            RGB_LED_Halt();
+            RGB_LED_Show(s_pattern.rest);
+            return;
+        }
+    }
 
-        case RGB_MAGENTA:
-            GPIO_PORTC_DATA_R |= (RGB_RED_PIN | RGB_BLUE_PIN);
-            break;
+    if (RGB_LED_Frame(&v) == TRUE)
+    {
+        RGB_LED_Show(v);
+    }
+    else
+    {
+        RGB_LED_Halt();
+        RGB_LED_Show(s_pattern.rest);
+    }
+}
 
-        case RGB_WHITE:
-            GPIO_PORTC_DATA_R |= RGB_ALL_PINS;
-            break;
+RGB_ValueType RGB_LED_ColorValue(RGB_Color_t color)
+{
+    RGB_ValueType v = { 0u, 0u, 0u };
 
+    switch (color)
+    {
+        case RGB_RED:     v.r = RGB_LEVEL_MAX; break;
+        case RGB_GREEN:   v.g = RGB_LEVEL_MAX; break;
+        case RGB_BLUE:    v.b = RGB_LEVEL_MAX; break;
+        case RGB_YELLOW:  v.r = RGB_LEVEL_MAX; v.g = RGB_LEVEL_MAX; break;
+        case RGB_CYAN:    v.g = RGB_LEVEL_MAX; v.b = RGB_LEVEL_MAX; break;
+        case RGB_MAGENTA: v.r = RGB_LEVEL_MAX; v.b = RGB_LEVEL_MAX; break;
+        case RGB_WHITE:   v.r = RGB_LEVEL_MAX; v.g = RGB_LEVEL_MAX; v.b = RGB_LEVEL_MAX; break;
         case RGB_OFF:
         default:
-            /* already OFF */
+            /* all off */
             break;
     }
+
+    return v;
+}
+
+void RGB_LED_SetColor(RGB_Color_t color)
+{
+    RGB_LED_SetRgb(RGB_LED_ColorValue(color));
+}
+
+void RGB_LED_SetRgb(RGB_ValueType value)
+{
+    RGB_LED_Halt();
+    RGB_LED_Show(value);
+}
+
+RGB_ValueType RGB_LED_GetRgb(void)
+{
+    return s_now;
+}
+
+Std_ReturnType RGB_LED_Play(const RGB_PatternType *pattern)
+{
+    RGB_ValueType v;
+
+    if ((pattern == (const RGB_PatternType *)0) || (pattern->period_ms < RGB_TICK_MS))
+    {
+        return E_NOT_OK;
+    }
+
+    /* Tick stopped, so the ISR cannot see a half-written pattern */
+    RGB_LED_Halt();
+
+    s_pattern = *pattern;
+    s_from = s_now;
+    s_phase_ms = 0u;
+    s_cycle = 0u;
+
+    (void)RGB_LED_Frame(&v);
+    RGB_LED_Show(v);
+
+    s_playing = TRUE;
+    RGB_LED_StartTick(Clock_GetSysClkHz());
+
+    return E_OK;
+}
+
+boolean RGB_LED_IsPlaying(void)
+{
+    return s_playing;
 }
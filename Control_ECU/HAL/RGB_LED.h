@@ -2,6 +2,11 @@
 #define RGB_LED_H_
 
 #include <stdint.h>
+#include "../Common/Std_Types.h"
+
+/* Patterns advance in the tick ISR this often */
+#define RGB_TICK_MS         (10u)
+#define RGB_PWM_HZ          (1000u)
 
 typedef enum
 {
@@ -15,7 +20,49 @@ typedef enum
     RGB_WHITE
 } RGB_Color_t;
 
+/* 8-bit intensities as the eye sees them; the driver gamma-corrects */
+typedef struct
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} RGB_ValueType;
+
+typedef enum
+{
+    RGB_PATTERN_BLINK = 0,  /* color for period_ms, off for period_ms; no off after the last */
+    RGB_PATTERN_BREATHE,    /* off -> color -> off over period_ms */
+    RGB_PATTERN_FADE        /* from what is showing to color over period_ms, then holds it */
+} RGB_PatternKind;
+
+typedef struct
+{
+    RGB_PatternKind kind;
+    RGB_ValueType   color;
+    uint16_t        period_ms;  /* at least RGB_TICK_MS */
+    uint8_t         count;      /* cycles, 0 = until replaced; FADE runs once */
+    RGB_ValueType   rest;       /* shown once the last cycle ends (not FADE) */
+} RGB_PatternType;
+
 void RGB_LED_Init(void);
+
+/* Stop any pattern and show a steady color */
 void RGB_LED_SetColor(RGB_Color_t color);
+void RGB_LED_SetRgb(RGB_ValueType value);
+
+/* Full-intensity value of a named color */
+RGB_ValueType RGB_LED_ColorValue(RGB_Color_t color);
+
+/* On the pins now, before gamma */
+RGB_ValueType RGB_LED_GetRgb(void);
+
+/* Replaces whatever is showing and returns at once; the tick ISR runs it.
+ * E_NOT_OK for a NULL pattern or period_ms under RGB_TICK_MS. Not
+ * reentrant: callers in several tasks serialize. */
+Std_ReturnType RGB_LED_Play(const RGB_PatternType *pattern);
+boolean RGB_LED_IsPlaying(void);
+
+/* Timer0A vector: one pattern step */
+void TIMER0A_Handler(void);
 
-#endif
+#endif /* RGB_LED_H_ */
@@ -0,0 +1,35 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <stdint.h>
+#include "../Common/Std_Types.h"
+
+/* Reset clock: PIOSC, 16 MHz */
+#define CLOCK_RESET_HZ          (16000000u)
+
+/* Common operating points */
+#define CLOCK_80MHZ             (80000000u)
+#define CLOCK_50MHZ             (50000000u)
+#define CLOCK_40MHZ             (40000000u)
+#define CLOCK_20MHZ             (20000000u)
+#define CLOCK_16MHZ             (16000000u)
+
+#define CLOCK_MAX_LISTENERS     (4u)
+
+/* Called with the new SYSCLK after every change, the 16 MHz fallback
+ * below included */
+typedef void (*Clock_ListenerType)(uint32_t sysclk_hz);
+
+/* Switch SYSCLK. 16 MHz runs straight from the crystal with the PLL powered
+ * down; any other rate must divide 400 MHz by 5..128 (80, 50, 40, 20 MHz...).
+ * Returns E_NOT_OK for unsupported rates, with the clock left unchanged, and
+ * on PLL lock timeout, with SYSCLK left on the 16 MHz crystal (listeners
+ * are told). */
+Std_ReturnType Clock_Init(uint32_t sysclk_hz);
+
+uint32_t Clock_GetSysClkHz(void);
+
+/* Drivers register here so their dividers follow Clock_Init() at runtime */
+Std_ReturnType Clock_RegisterListener(Clock_ListenerType listener);
+
+#endif /* CLOCK_H_ */
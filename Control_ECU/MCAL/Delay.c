@@ -1,21 +1,29 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
 #include "delay.h"
+#include "Clock.h"
+#include "Kernel.h"
 
 /* SysTick runs from system clock.
- * At 16 MHz: 1 ms = 16000 cycles.
+ * 1 ms = SYSCLK / 1000 cycles (16000 at 16 MHz, 80000 at 80 MHz).
  */
-#define SYSCLK_HZ           (16000000u)
-#define SYSTICK_1MS_RELOAD  ((SYSCLK_HZ / 1000u) - 1u)
+#define SYSTICK_1MS_RELOAD(hz)  (((hz) / 1000u) - 1u)
 
 static volatile uint32_t g_msTicks = 0u;
 
+static void Delay_OnClockChange(uint32_t sysclk_hz)
+{
+    /* Keep counting; the new period starts at the next wrap */
+    NVIC_ST_RELOAD_R = SYSTICK_1MS_RELOAD(sysclk_hz);
+}
+
 void SysTick_Handler(void)
 {
     g_msTicks++;
+    Kernel_Tick();
 }
 
-void Delay_Init_16MHz(void)
+void Delay_Init(void)
 {
     g_msTicks = 0u;
 
@@ -23,7 +31,7 @@ void Delay_Init_16MHz(void)
     NVIC_ST_CTRL_R = 0u;
 
     /* Reload for 1ms tick */
-    NVIC_ST_RELOAD_R = SYSTICK_1MS_RELOAD;
+    NVIC_ST_RELOAD_R = SYSTICK_1MS_RELOAD(Clock_GetSysClkHz());
 
     /* Clear current value */
     NVIC_ST_CURRENT_R = 0u;
@@ -34,12 +42,21 @@ void Delay_Init_16MHz(void)
      * - enable (ENABLE=1)
      */
     NVIC_ST_CTRL_R = (1u << 2) | (1u << 1) | (1u << 0);
+
+    (void)Clock_RegisterListener(Delay_OnClockChange);
 }
 
 void Delay_ms(uint32_t ms)
 {
     uint32_t start = g_msTicks;
 
+    /* Inside a task, block and let lower priorities run */
+    if (Kernel_IsRunning() == TRUE)
+    {
+        Kernel_Sleep(ms);
+        return;
+    }
+
     while ((g_msTicks - start) < ms)
     {
         /* wait */
@@ -3,7 +3,7 @@
 
 #include <stdint.h>
 
-void Delay_Init_16MHz(void);
+void Delay_Init(void);
 void Delay_ms(uint32_t ms);
 
 #endif /* DELAY_H_ */
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
 #include "EEPROM.h"
+#include "Profile.h"
 
 /*
 EEPROM mapping (Block 0):
@@ -151,11 +152,13 @@ void EEPROM_Save(const char pass5[5], uint8_t timeout_sec, uint8_t initialized)
 
     p4w = (uint32_t)(uint8_t)pass5[4];
 
+    PROFILE_BEGIN(PROF_ZONE_EEPROM_SAVE);
     EEPROM_WriteWord(OFF_MAGIC, EE_MAGIC);
     EEPROM_WriteWord(OFF_INIT, (uint32_t)init_val);
     EEPROM_WriteWord(OFF_TIMEOUT, (uint32_t)t);
     EEPROM_WriteWord(OFF_PASS01_23, p0123);
     EEPROM_WriteWord(OFF_PASS4, p4w);
+    PROFILE_END(PROF_ZONE_EEPROM_SAVE);
 }
 
 void EEPROM_Clear(void)
@@ -0,0 +1,425 @@
+#include <stdint.h>
+#include <intrinsics.h>
+#include "TM4C123GH6PM.h"
+#include "Kernel.h"
+
+/* PendSV last so it never preempts another handler; SysTick just above */
+#define NVIC_INT_CTRL_PENDSVSET_MASK    (1u << 28)
+#define NVIC_SYS_PRI3_PENDSV_MASK       (7u << 21)
+#define NVIC_SYS_PRI3_TICK_MASK         (7u << 29)
+#define NVIC_SYS_PRI3_PENDSV_PRIO       (7u << 21)
+#define NVIC_SYS_PRI3_TICK_PRIO         (6u << 29)
+
+/* Initial frame: hardware part popped on exception return, software part
+ * (r4-r11 + EXC_RETURN) popped by Kernel_Port.s */
+#define KERNEL_XPSR_THUMB               (0x01000000u)
+#define KERNEL_EXC_RETURN_THREAD_PSP    (0xFFFFFFFDu)   /* no FP frame */
+#define KERNEL_HW_FRAME_WORDS           (8u)
+#define KERNEL_SW_FRAME_WORDS           (9u)
+#define KERNEL_HW_FRAME_PC              (6u)
+#define KERNEL_HW_FRAME_LR              (5u)
+#define KERNEL_HW_FRAME_XPSR            (7u)
+#define KERNEL_SW_FRAME_EXC_RETURN      (8u)
+
+#define KERNEL_STACK_PAINT              (0xDEADBEEFu)
+#define KERNEL_IDLE_STACK_WORDS         (KERNEL_MIN_STACK_WORDS)
+#define KERNEL_LINE_LEN                 (48u)
+
+typedef enum
+{
+    TASK_READY = 0,
+    TASK_SLEEPING,
+    TASK_WAITING,
+    TASK_DORMANT
+} Kernel_TaskState;
+
+typedef struct
+{
+    uint32_t        *sp;            /* must stay first: read by Kernel_Port.s */
+    uint32_t        *stack;
+    uint32_t         stack_words;
+    uint32_t         wake_tick;
+    uint32_t         events;
+    uint32_t         wait_mask;
+    boolean          timed;
+    uint8_t          prio;
+    Kernel_TaskState state;
+    const char      *name;
+} Kernel_Tcb;
+
+/* Shared with Kernel_Port.s */
+Kernel_Tcb * volatile Kernel_CurrentTcb = (Kernel_Tcb *)0;
+volatile uint32_t Kernel_SwitchStartCycles = 0u;
+volatile uint32_t Kernel_SwitchLastCycles  = 0u;
+void Kernel_SelectNext(void);
+extern void Kernel_PortStartFirst(uint32_t *sp);
+
+static Kernel_Tcb s_tasks[KERNEL_MAX_TASKS];
+static uint8_t    s_task_count = 0u;
+static volatile uint32_t s_ticks = 0u;
+static volatile boolean  s_running = FALSE;
+
+static uint32_t s_idle_stack[KERNEL_IDLE_STACK_WORDS];
+
+static void Kernel_Pend(void)
+{
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PENDSVSET_MASK;
+}
+
+/* Wake-ups come from the tick or another task; only preempt for a better one */
+static void Kernel_PendIfOutranks(const Kernel_Tcb *t)
+{
+    if ((s_running == TRUE) && (t->prio > Kernel_CurrentTcb->prio))
+    {
+        Kernel_Pend();
+    }
+}
+
+static void Kernel_TaskExit(void)
+{
+    /* Tasks are loops; one that returns just parks */
+    (void)Kernel_EnterCritical();
+    Kernel_CurrentTcb->state = TASK_DORMANT;
+    Kernel_Pend();
+    __enable_interrupt();
+
+    for (;;)
+    {
+        /* never scheduled again */
+    }
+}
+
+static void Kernel_IdleTask(void)
+{
+    for (;;)
+    {
+        /* Spin rather than WFI: CYCCNT stops in sleep and profile zones
+         * that span a wait should still read wall-clock cycles */
+    }
+}
+
+static Std_ReturnType Kernel_AddTask(Kernel_TaskFn entry, uint8_t prio,
+                                     uint32_t *stack, uint32_t stack_words,
+                                     const char *name, Kernel_TaskId *id)
+{
+    Kernel_Tcb *t;
+    uint32_t *sp;
+    uint32_t i;
+
+    if ((entry == (Kernel_TaskFn)0) || (stack == (uint32_t *)0) ||
+        (stack_words < KERNEL_MIN_STACK_WORDS) || (s_running == TRUE) ||
+        (s_task_count >= KERNEL_MAX_TASKS))
+    {
+        return E_NOT_OK;
+    }
+
+    for (i = 0u; i < s_task_count; i++)
+    {
+        if (s_tasks[i].prio == prio)
+        {
+            return E_NOT_OK;
+        }
+    }
+
+    for (i = 0u; i < stack_words; i++)
+    {
+        stack[i] = KERNEL_STACK_PAINT;
+    }
+
+    /* AAPCS: 8-byte aligned stack at exception entry */
+    sp = (uint32_t *)((uintptr_t)&stack[stack_words] & ~(uintptr_t)7u);
+
+    sp -= KERNEL_HW_FRAME_WORDS;
+    for (i = 0u; i < KERNEL_HW_FRAME_WORDS; i++)
+    {
+        sp[i] = 0u;
+    }
+    sp[KERNEL_HW_FRAME_LR]   = (uint32_t)(uintptr_t)Kernel_TaskExit;
+    sp[KERNEL_HW_FRAME_PC]   = (uint32_t)(uintptr_t)entry & ~1u;   /* exception return wants bit 0 clear */
+    sp[KERNEL_HW_FRAME_XPSR] = KERNEL_XPSR_THUMB;
+
+    sp -= KERNEL_SW_FRAME_WORDS;
+    for (i = 0u; i < KERNEL_SW_FRAME_WORDS; i++)
+    {
+        sp[i] = 0u;
+    }
+    sp[KERNEL_SW_FRAME_EXC_RETURN] = KERNEL_EXC_RETURN_THREAD_PSP;
+
+    t = &s_tasks[s_task_count];
+    t->sp          = sp;
+    t->stack       = stack;
+    t->stack_words = stack_words;
+    t->wake_tick   = 0u;
+    t->events      = 0u;
+    t->wait_mask   = 0u;
+    t->timed       = FALSE;
+    t->prio        = prio;
+    t->state       = TASK_READY;
+    t->name        = name;
+
+    if (id != (Kernel_TaskId *)0)
+    {
+        *id = s_task_count;
+    }
+    s_task_count++;
+
+    return E_OK;
+}
+
+/* Copy helpers for Kernel_Dump: no printf on target */
+static uint8_t Kernel_AppendStr(char *buf, uint8_t pos, const char *str)
+{
+    while ((*str != '\0') && (pos < (KERNEL_LINE_LEN - 3u)))
+    {
+        buf[pos] = *str;
+        pos++;
+        str++;
+    }
+    return pos;
+}
+
+static uint8_t Kernel_AppendNum(char *buf, uint8_t pos, uint32_t value)
+{
+    char tmp[10];
+    uint8_t n = 0u;
+
+    do
+    {
+        tmp[n] = (char)('0' + (char)(value % 10u));
+        n++;
+        value /= 10u;
+    } while ((value > 0u) && (n < (uint8_t)sizeof(tmp)));
+
+    while ((n > 0u) && (pos < (KERNEL_LINE_LEN - 3u)))
+    {
+        n--;
+        buf[pos] = tmp[n];
+        pos++;
+    }
+    return pos;
+}
+
+void Kernel_Init(void)
+{
+    if (s_running == TRUE) { return; }
+
+    s_task_count = 0u;
+    s_ticks = 0u;
+}
+
+Std_ReturnType Kernel_CreateTask(Kernel_TaskFn entry, uint8_t prio,
+                                 uint32_t *stack, uint32_t stack_words,
+                                 const char *name, Kernel_TaskId *id)
+{
+    if (prio == KERNEL_IDLE_PRIO)
+    {
+        return E_NOT_OK;
+    }
+
+    return Kernel_AddTask(entry, prio, stack, stack_words, name, id);
+}
+
+void Kernel_Start(void)
+{
+    (void)Kernel_AddTask(Kernel_IdleTask, KERNEL_IDLE_PRIO, s_idle_stack,
+                         KERNEL_IDLE_STACK_WORDS, "Idle", (Kernel_TaskId *)0);
+
+    NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~(NVIC_SYS_PRI3_PENDSV_MASK | NVIC_SYS_PRI3_TICK_MASK))
+                    | NVIC_SYS_PRI3_PENDSV_PRIO | NVIC_SYS_PRI3_TICK_PRIO;
+
+    __disable_interrupt();
+
+    Kernel_CurrentTcb = &s_tasks[0];
+    Kernel_SelectNext();
+    s_running = TRUE;
+
+    /* Switches to PSP, enables interrupts and jumps into the task */
+    Kernel_PortStartFirst(Kernel_CurrentTcb->sp);
+}
+
+boolean Kernel_IsRunning(void)
+{
+    return s_running;
+}
+
+void Kernel_Tick(void)
+{
+    uint32_t cs;
+    uint8_t i;
+
+    if (s_running == FALSE) { return; }
+
+    cs = Kernel_EnterCritical();
+    s_ticks++;
+
+    for (i = 0u; i < s_task_count; i++)
+    {
+        Kernel_Tcb *t = &s_tasks[i];
+        boolean timed_out = ((int32_t)(s_ticks - t->wake_tick) >= 0) ? TRUE : FALSE;
+
+        if ((timed_out == TRUE) &&
+            ((t->state == TASK_SLEEPING) || ((t->state == TASK_WAITING) && (t->timed == TRUE))))
+        {
+            t->state = TASK_READY;
+            Kernel_PendIfOutranks(t);
+        }
+    }
+
+    Kernel_ExitCritical(cs);
+}
+
+void Kernel_Sleep(uint32_t ms)
+{
+    uint32_t cs;
+
+    if (s_running == FALSE) { return; }
+
+    cs = Kernel_EnterCritical();
+    if (ms > 0u)
+    {
+        Kernel_CurrentTcb->wake_tick = s_ticks + ms;
+        Kernel_CurrentTcb->state     = TASK_SLEEPING;
+    }
+    Kernel_Pend();
+    Kernel_ExitCritical(cs);    /* PendSV runs here */
+}
+
+uint32_t Kernel_WaitEvents(uint32_t mask, uint32_t timeout_ms)
+{
+    Kernel_Tcb *self = Kernel_CurrentTcb;
+    uint32_t got;
+    uint32_t cs;
+
+    if (s_running == FALSE) { return 0u; }
+
+    cs = Kernel_EnterCritical();
+    got = self->events & mask;
+
+    if ((got == 0u) && (timeout_ms != 0u))
+    {
+        self->wait_mask = mask;
+        self->timed     = (timeout_ms != KERNEL_WAIT_FOREVER) ? TRUE : FALSE;
+        self->wake_tick = s_ticks + timeout_ms;
+        self->state     = TASK_WAITING;
+        Kernel_Pend();
+        Kernel_ExitCritical(cs);    /* blocked here until set or timed out */
+
+        cs = Kernel_EnterCritical();
+        got = self->events & mask;
+    }
+
+    self->events &= ~got;
+    Kernel_ExitCritical(cs);
+
+    return got;
+}
+
+void Kernel_SetEvents(Kernel_TaskId id, uint32_t events)
+{
+    Kernel_Tcb *t;
+    uint32_t cs;
+
+    if (id >= s_task_count) { return; }
+
+    cs = Kernel_EnterCritical();
+    t = &s_tasks[id];
+    t->events |= events;
+
+    if ((t->state == TASK_WAITING) && ((t->events & t->wait_mask) != 0u))
+    {
+        t->state = TASK_READY;
+        Kernel_PendIfOutranks(t);
+    }
+    Kernel_ExitCritical(cs);
+}
+
+uint32_t Kernel_EnterCritical(void)
+{
+    uint32_t state = (uint32_t)__get_interrupt_state();
+
+    __disable_interrupt();
+    return state;
+}
+
+void Kernel_ExitCritical(uint32_t state)
+{
+    __set_interrupt_state((__istate_t)state);
+}
+
+uint32_t Kernel_GetStackHighWater(Kernel_TaskId id)
+{
+    const Kernel_Tcb *t;
+    uint32_t untouched = 0u;
+
+    if (id >= s_task_count) { return 0u; }
+
+    t = &s_tasks[id];
+
+    /* Stacks grow down: count paint left at the bottom */
+    while ((untouched < t->stack_words) && (t->stack[untouched] == KERNEL_STACK_PAINT))
+    {
+        untouched++;
+    }
+
+    return (t->stack_words - untouched) * 4u;
+}
+
+void Kernel_Dump(Profile_PrintFn print)
+{
+    char line[KERNEL_LINE_LEN];
+    uint8_t pos;
+    uint8_t i;
+
+    if (print == (Profile_PrintFn)0) { return; }
+
+    print("task prio used size\r\n");
+
+    for (i = 0u; i < s_task_count; i++)
+    {
+        pos = Kernel_AppendStr(line, 0u, s_tasks[i].name);
+        pos = Kernel_AppendStr(line, pos, " ");
+        pos = Kernel_AppendNum(line, pos, s_tasks[i].prio);
+        pos = Kernel_AppendStr(line, pos, " ");
+        pos = Kernel_AppendNum(line, pos, Kernel_GetStackHighWater(i));
+        pos = Kernel_AppendStr(line, pos, " ");
+        pos = Kernel_AppendNum(line, pos, s_tasks[i].stack_words * 4u);
+
+        line[pos]      = '\r';
+        line[pos + 1u] = '\n';
+        line[pos + 2u] = '\0';
+        print(line);
+    }
+}
+
+/* PendSV, interrupts masked, outgoing context already saved */
+void Kernel_SelectNext(void)
+{
+    Kernel_Tcb *best = Kernel_CurrentTcb;
+    uint8_t i;
+
+    /* Cost of the previous switch, stamped by Kernel_Port.s on its way out */
+    if (Kernel_SwitchLastCycles != 0u)
+    {
+        Profile_Record(PROF_ZONE_KERNEL_SWITCH, Kernel_SwitchLastCycles);
+        Kernel_SwitchLastCycles = 0u;
+    }
+
+    if (best->state != TASK_READY)
+    {
+        best = (Kernel_Tcb *)0;
+    }
+
+    /* Idle (prio 0) is always ready, so something is always picked */
+    for (i = 0u; i < s_task_count; i++)
+    {
+        Kernel_Tcb *t = &s_tasks[i];
+
+        if ((t->state == TASK_READY) &&
+            ((best == (Kernel_Tcb *)0) || (t->prio > best->prio)))
+        {
+            best = t;
+        }
+    }
+
+    Kernel_CurrentTcb = best;
+}
@@ -0,0 +1,57 @@
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include <stdint.h>
+#include "../Common/Std_Types.h"
+#include "Profile.h"
+
+/* Static, priority-preemptive micro-kernel: SysTick drives time, PendSV
+ * switches context (Kernel_Port.s). Higher number = higher priority, one
+ * task per priority, so there is never any round-robin. */
+
+#define KERNEL_MAX_TASKS            (5u)        /* application tasks + idle */
+#define KERNEL_IDLE_PRIO            (0u)        /* reserved for the idle task */
+#define KERNEL_MIN_STACK_WORDS      (64u)
+#define KERNEL_WAIT_FOREVER         (0xFFFFFFFFu)
+
+typedef void (*Kernel_TaskFn)(void);
+typedef uint8_t Kernel_TaskId;
+
+/* Forget all tasks; only before Kernel_Start() */
+void Kernel_Init(void);
+
+/* Stack is caller-owned and painted for high-water tracking. Fails for a
+ * taken or reserved priority, a short stack, or once the kernel runs. */
+Std_ReturnType Kernel_CreateTask(Kernel_TaskFn entry, uint8_t prio,
+                                 uint32_t *stack, uint32_t stack_words,
+                                 const char *name, Kernel_TaskId *id);
+
+/* Adds the idle task and runs the highest-priority task; never returns */
+void Kernel_Start(void);
+
+boolean Kernel_IsRunning(void);
+
+/* Called from SysTick_Handler every millisecond */
+void Kernel_Tick(void);
+
+/* Task context only. 0 ms yields to any ready higher-priority task. */
+void Kernel_Sleep(uint32_t ms);
+
+/* Task context only. Returns and clears the bits of mask that were set,
+ * or 0 after timeout_ms (0 = poll, KERNEL_WAIT_FOREVER = no timeout). */
+uint32_t Kernel_WaitEvents(uint32_t mask, uint32_t timeout_ms);
+
+/* Task or ISR context; preempts if the woken task outranks the caller */
+void Kernel_SetEvents(Kernel_TaskId id, uint32_t events);
+
+/* Short mutual exclusion against tasks and the tick */
+uint32_t Kernel_EnterCritical(void);
+void Kernel_ExitCritical(uint32_t state);
+
+/* Deepest stack use seen so far, in bytes */
+uint32_t Kernel_GetStackHighWater(Kernel_TaskId id);
+
+/* name prio used size, one task per line (switch cost is PROF_ZONE_KERNEL_SWITCH) */
+void Kernel_Dump(Profile_PrintFn print);
+
+#endif /* KERNEL_H_ */
@@ -0,0 +1,92 @@
+;========================================================
+; File: Kernel_Port.s
+; Brief: Cortex-M4F context switch for Kernel.c
+;
+; Task stack, top down: hardware frame (r0-r3, r12, lr, pc, xPSR,
+; plus s0-s15/FPSCR when the task used the FPU), then s16-s31 if
+; EXC_RETURN bit 4 is clear, then r4-r11 and EXC_RETURN.
+; Kernel_Tcb.sp (offset 0) points at the saved r4.
+;========================================================
+
+DWT_CYCCNT      EQU     0xE0001004
+CONTROL_PSP     EQU     0x2                 ; thread mode on PSP, privileged
+HW_FRAME_BYTES  EQU     32
+HW_FRAME_LR     EQU     20
+HW_FRAME_PC     EQU     24
+
+        MODULE  Kernel_Port
+
+        PUBLIC  PendSV_Handler
+        PUBLIC  Kernel_PortStartFirst
+
+        EXTERN  Kernel_CurrentTcb
+        EXTERN  Kernel_SwitchStartCycles
+        EXTERN  Kernel_SwitchLastCycles
+        EXTERN  Kernel_SelectNext
+
+        SECTION .text:CODE:NOROOT(2)
+        THUMB
+
+PendSV_Handler:
+        ; Stamp entry for the switch-cost zone
+        LDR     r2, =DWT_CYCCNT
+        LDR     r3, [r2]
+        LDR     r2, =Kernel_SwitchStartCycles
+        STR     r3, [r2]
+
+        ; Save outgoing context on its own stack
+        MRS     r0, PSP
+        TST     lr, #0x10
+        IT      EQ
+        VSTMDBEQ r0!, {s16-s31}
+        STMDB   r0!, {r4-r11, lr}
+
+        LDR     r1, =Kernel_CurrentTcb
+        LDR     r2, [r1]
+        STR     r0, [r2]
+
+        ; Pick the next task with the tick and other tasks held off
+        CPSID   i
+        BL      Kernel_SelectNext
+        CPSIE   i
+
+        ; Restore incoming context
+        LDR     r1, =Kernel_CurrentTcb
+        LDR     r2, [r1]
+        LDR     r0, [r2]
+        LDMIA   r0!, {r4-r11, lr}
+        TST     lr, #0x10
+        IT      EQ
+        VLDMIAEQ r0!, {s16-s31}
+        MSR     PSP, r0
+
+        ; Kernel_SwitchLastCycles = CYCCNT - entry stamp
+        LDR     r2, =DWT_CYCCNT
+        LDR     r3, [r2]
+        LDR     r2, =Kernel_SwitchStartCycles
+        LDR     r1, [r2]
+        SUBS    r3, r3, r1
+        LDR     r2, =Kernel_SwitchLastCycles
+        STR     r3, [r2]
+
+        BX      lr
+
+; void Kernel_PortStartFirst(uint32_t *sp)
+; Called once from Kernel_Start() with interrupts masked. Unwinds the
+; initial frame by hand and never returns; main() keeps MSP for handlers.
+; LR comes from the frame as well, so a first task that returns parks in
+; Kernel_TaskExit like any other.
+Kernel_PortStartFirst:
+        LDMIA   r0!, {r4-r11, lr}           ; lr = EXC_RETURN, unused here
+        LDR     lr, [r0, #HW_FRAME_LR]      ; Kernel_TaskExit
+        LDR     r1, [r0, #HW_FRAME_PC]
+        ORR     r1, r1, #1                  ; back to a Thumb address for BX
+        ADDS    r0, r0, #HW_FRAME_BYTES
+        MSR     PSP, r0
+        MOVS    r2, #CONTROL_PSP
+        MSR     CONTROL, r2
+        ISB
+        CPSIE   i
+        BX      r1
+
+        END
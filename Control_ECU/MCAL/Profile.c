@@ -0,0 +1,157 @@
+#include <stdint.h>
+#include "Profile.h"
+
+/* DWT / debug core registers (not in the device header) */
+#define CORE_DEMCR_R                (*((volatile uint32_t *)0xE000EDFCu))
+#define DWT_CTRL_R                  (*((volatile uint32_t *)0xE0001000u))
+#define DWT_CYCCNT_R                (*((volatile uint32_t *)0xE0001004u))
+
+#define CORE_DEMCR_TRCENA_MASK      (1u << 24)
+#define DWT_CTRL_CYCCNTENA_MASK     (1u << 0)
+
+#define PROFILE_LINE_LEN            (64u)
+
+static const char * const s_zone_names[PROF_ZONE_COUNT] =
+{
+    "EEPROM_Save",
+    "Handle_I",
+    "Handle_V",
+    "Handle_N",
+    "Handle_G",
+    "Handle_S",
+    "Handle_R",
+    "Handle_O",
+    "Handle_L",
+    "Handle_Unknown",
+    "Kernel_Switch"
+};
+
+static Profile_ZoneStats s_zones[PROF_ZONE_COUNT];
+
+/* Append helpers for Profile_Dump: no printf on target */
+static uint8_t Profile_AppendStr(char *buf, uint8_t pos, const char *str)
+{
+    while ((*str != '\0') && (pos < (PROFILE_LINE_LEN - 3u)))
+    {
+        buf[pos] = *str;
+        pos++;
+        str++;
+    }
+    return pos;
+}
+
+static uint8_t Profile_AppendNum(char *buf, uint8_t pos, uint32_t value)
+{
+    char tmp[10];
+    uint8_t n = 0u;
+
+    do
+    {
+        tmp[n] = (char)('0' + (char)(value % 10u));
+        n++;
+        value /= 10u;
+    } while ((value > 0u) && (n < (uint8_t)sizeof(tmp)));
+
+    while ((n > 0u) && (pos < (PROFILE_LINE_LEN - 3u)))
+    {
+        n--;
+        buf[pos] = tmp[n];
+        pos++;
+    }
+    return pos;
+}
+
+void Profile_Init(void)
+{
+    CORE_DEMCR_R |= CORE_DEMCR_TRCENA_MASK;
+    DWT_CYCCNT_R  = 0u;
+    DWT_CTRL_R   |= DWT_CTRL_CYCCNTENA_MASK;
+
+    Profile_Reset();
+}
+
+void Profile_Reset(void)
+{
+    uint8_t i;
+
+    for (i = 0u; i < (uint8_t)PROF_ZONE_COUNT; i++)
+    {
+        s_zones[i].count        = 0u;
+        s_zones[i].min_cycles   = 0xFFFFFFFFu;
+        s_zones[i].max_cycles   = 0u;
+        s_zones[i].total_cycles = 0u;
+        s_zones[i].start        = 0u;
+    }
+}
+
+uint32_t Profile_GetCycles(void)
+{
+    return DWT_CYCCNT_R;
+}
+
+void Profile_Begin(Profile_ZoneId zone)
+{
+    if (zone >= PROF_ZONE_COUNT) { return; }
+
+    s_zones[zone].start = DWT_CYCCNT_R;
+}
+
+void Profile_End(Profile_ZoneId zone)
+{
+    if (zone >= PROF_ZONE_COUNT) { return; }
+
+    /* Unsigned subtraction handles one CYCCNT wrap */
+    Profile_Record(zone, DWT_CYCCNT_R - s_zones[zone].start);
+}
+
+void Profile_Record(Profile_ZoneId zone, uint32_t cycles)
+{
+    Profile_ZoneStats *z;
+
+    if (zone >= PROF_ZONE_COUNT) { return; }
+
+    z = &s_zones[zone];
+
+    z->count++;
+    z->total_cycles += cycles;
+    if (cycles < z->min_cycles) { z->min_cycles = cycles; }
+    if (cycles > z->max_cycles) { z->max_cycles = cycles; }
+}
+
+const Profile_ZoneStats *Profile_GetZone(Profile_ZoneId zone)
+{
+    if (zone >= PROF_ZONE_COUNT) { return (const Profile_ZoneStats *)0; }
+
+    return &s_zones[zone];
+}
+
+void Profile_Dump(Profile_PrintFn print)
+{
+    char line[PROFILE_LINE_LEN];
+    uint8_t pos;
+    uint8_t i;
+
+    if (print == (Profile_PrintFn)0) { return; }
+
+    print("zone count min max total\r\n");
+
+    for (i = 0u; i < (uint8_t)PROF_ZONE_COUNT; i++)
+    {
+        const Profile_ZoneStats *z = &s_zones[i];
+
+        pos = Profile_AppendStr(line, 0u, s_zone_names[i]);
+        pos = Profile_AppendStr(line, pos, " ");
+        pos = Profile_AppendNum(line, pos, z->count);
+        pos = Profile_AppendStr(line, pos, " ");
+        pos = Profile_AppendNum(line, pos, (z->count > 0u) ? z->min_cycles : 0u);
+        pos = Profile_AppendStr(line, pos, " ");
+        pos = Profile_AppendNum(line, pos, z->max_cycles);
+        pos = Profile_AppendStr(line, pos, " ");
+        pos = Profile_AppendNum(line, pos, z->total_cycles);
+
+        line[pos]      = '\r';
+        line[pos + 1u] = '\n';
+        line[pos + 2u] = '\0';
+        print(line);
+    }
+}
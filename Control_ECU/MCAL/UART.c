@@ -1,9 +1,9 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
 #include "UART.h"
+#include "Clock.h"
 
 /* ================== CONFIG ================== */
-#define SYSCLK_HZ           (16000000u)
 #define UART_DIV_MUL        (16u)
 
 /* GPIOB clock + UART1 clock masks */
@@ -16,6 +16,7 @@
 #define GPIO_PB01_MASK      (GPIO_PB0_MASK | GPIO_PB1_MASK)
 
 /* UART flags */
+#define UART_FR_BUSY_MASK   (1u << 3)
 #define UART_FR_TXFF_MASK   (1u << 5)
 #define UART_FR_RXFE_MASK   (1u << 4)
 
@@ -27,9 +28,28 @@
 /* UART LCRH fields */
 #define UART_LCRH_WLEN_8     (0x3u << 5)   /* 8-bit word length */
 
+/* UART interrupt bits (IM / MIS / ICR) */
+#define UART_INT_RX_MASK     (1u << 4)
+#define UART_INT_OE_MASK     (1u << 10)
+
+#define NVIC_EN0_UART1_MASK  (1u << 6)     /* IRQ 6 */
+
+/* Software RX ring, filled by UART1_Handler. Power of two. */
+#define UART_RX_RING_SIZE    (32u)
+#define UART_RX_RING_MASK    (UART_RX_RING_SIZE - 1u)
+
+static uint32_t s_baudrate = 9600u;
+
+static volatile uint8_t s_rx_ring[UART_RX_RING_SIZE];
+static volatile uint8_t s_rx_head = 0u;   /* written by the ISR only  */
+static volatile uint8_t s_rx_tail = 0u;   /* written by readers only  */
+static volatile uint32_t s_rx_dropped = 0u;
+static UART1_RxNotifyFn s_rx_notify = (UART1_RxNotifyFn)0;
+
 static void UART1_SetBaudRate(uint32_t baudrate)
 {
     /* IBRD = SysClk / (16 * baud) */
+    uint32_t sysclk = Clock_GetSysClkHz();
     uint32_t denom = (UART_DIV_MUL * baudrate);
     uint32_t ibrd;
     uint32_t rem;
@@ -42,8 +62,8 @@ static void UART1_SetBaudRate(uint32_t baudrate)
         denom = (UART_DIV_MUL * baudrate);
     }
 
-    ibrd = (SYSCLK_HZ / denom);
-    rem  = (SYSCLK_HZ % denom);
+    ibrd = (sysclk / denom);
+    rem  = (sysclk % denom);
 
     /* FBRD = round( (rem / denom) * 64 )
      *      = round( rem * 64 / denom )
@@ -57,6 +77,26 @@ static void UART1_SetBaudRate(uint32_t baudrate)
 
     UART1_IBRD_R = (uint16_t)ibrd;
     UART1_FBRD_R = (uint8_t)fbrd;
+
+    s_baudrate = baudrate;
+}
+
+static void UART1_OnClockChange(uint32_t sysclk_hz)
+{
+    (void)sysclk_hz;
+
+    /* Finish the frame in flight before touching the divisor */
+    while ((UART1_FR_R & UART_FR_BUSY_MASK) != 0u)
+    {
+        /* wait */
+    }
+
+    UART1_CTL_R &= ~UART_CTL_UARTEN_MASK;
+    UART1_SetBaudRate(s_baudrate);
+
+    /* Divisor change only latches on an LCRH write */
+    UART1_LCRH_R = UART_LCRH_WLEN_8;
+    UART1_CTL_R |= UART_CTL_UARTEN_MASK;
 }
 
 void UART1_Init(uint32_t baudrate)
@@ -80,15 +120,68 @@ void UART1_Init(uint32_t baudrate)
     /* Disable UART1 while configuring */
     UART1_CTL_R &= ~UART_CTL_UARTEN_MASK;
 
-    /* Set baud rate (16 MHz) */
+    /* Set baud rate from current SYSCLK */
     UART1_SetBaudRate(baudrate);
 
-    /* 8N1, FIFOs disabled (leave FEN=0), no parity, 1 stop */
+    /* 8N1, FIFOs disabled (leave FEN=0), no parity, 1 stop.
+       The lowest FIFO trigger is 2 bytes, so a lone command byte would
+       wait for the receive timeout; one interrupt per byte into the
+       software ring gives the depth without that delay. */
     UART1_LCRH_R = UART_LCRH_WLEN_8;
 
+    s_rx_head = 0u;
+    s_rx_tail = 0u;
+    s_rx_dropped = 0u;
+
+    UART1_ICR_R = (UART_INT_RX_MASK | UART_INT_OE_MASK);
+    UART1_IM_R  = (UART_INT_RX_MASK | UART_INT_OE_MASK);
+
     /* Enable RX, TX and UART */
     UART1_CTL_R |= (UART_CTL_TXE_MASK | UART_CTL_RXE_MASK);
     UART1_CTL_R |= UART_CTL_UARTEN_MASK;
+
+    (void)Clock_RegisterListener(UART1_OnClockChange);
+
+    NVIC_EN0_R |= NVIC_EN0_UART1_MASK;
+}
+
+void UART1_SetRxNotify(UART1_RxNotifyFn fn)
+{
+    s_rx_notify = fn;
+}
+
+uint32_t UART1_GetRxDropped(void)
+{
+    return s_rx_dropped;
+}
+
+void UART1_Handler(void)
+{
+    uint8_t got = 0u;
+
+    UART1_ICR_R = (UART_INT_RX_MASK | UART_INT_OE_MASK);
+
+    while ((UART1_FR_R & UART_FR_RXFE_MASK) == 0u)
+    {
+        uint32_t dr = UART1_DR_R;
+        uint8_t next = (uint8_t)((s_rx_head + 1u) & UART_RX_RING_MASK);
+
+        if (next == s_rx_tail)
+        {
+            s_rx_dropped++;             /* ring full: newest byte lost */
+        }
+        else
+        {
+            s_rx_ring[s_rx_head] = (uint8_t)(dr & 0xFFu);
+            s_rx_head = next;
+            got = 1u;
+        }
+    }
+
+    if ((got != 0u) && (s_rx_notify != (UART1_RxNotifyFn)0))
+    {
+        s_rx_notify();
+    }
 }
 
 void UART1_SendByte(uint8_t data)
@@ -103,12 +196,28 @@ void UART1_SendByte(uint8_t data)
 
 uint8_t UART1_ReceiveByte(void)
 {
-    /* Wait until RX FIFO not empty */
-    while ((UART1_FR_R & UART_FR_RXFE_MASK) != 0u)
+    uint8_t b = 0u;
+
+    /* Wait until the ISR has queued a byte */
+    while (UART1_TryReceiveByte(&b) != E_OK)
     {
         /* wait */
     }
-    return (uint8_t)(UART1_DR_R & 0xFFu);
+    return b;
+}
+
+Std_ReturnType UART1_TryReceiveByte(uint8_t *out)
+{
+    uint8_t tail = s_rx_tail;
+
+    if ((out == (uint8_t *)0) || (tail == s_rx_head))
+    {
+        return E_NOT_OK;
+    }
+
+    *out = s_rx_ring[tail];
+    s_rx_tail = (uint8_t)((tail + 1u) & UART_RX_RING_MASK);
+    return E_OK;
 }
 
 void UART1_SendString(const char *str)
@@ -2,10 +2,18 @@
 #define UART_H_
 
 #include <stdint.h>
+#include "../Common/Std_Types.h"
+
+/* Called from UART1_Handler after it queues at least one byte */
+typedef void (*UART1_RxNotifyFn)(void);
 
 void UART1_Init(uint32_t baudrate);
 void UART1_SendByte(uint8_t data);
 uint8_t UART1_ReceiveByte(void);          /* blocking */
+Std_ReturnType UART1_TryReceiveByte(uint8_t *out);   /* E_NOT_OK if RX ring empty */
+void UART1_SetRxNotify(UART1_RxNotifyFn fn);
+uint32_t UART1_GetRxDropped(void);        /* bytes lost to a full RX ring */
+void UART1_Handler(void);
 void UART1_SendString(const char *str);
 
 #endif /* UART_H_ */
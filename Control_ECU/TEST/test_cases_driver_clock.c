@@ -0,0 +1,130 @@
+/**
+ * @file    test_cases_driver_clock.c
+ * @brief   Clock Driver Unit Tests Implementation - Control ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * @details Tests PLL switching and that clock-dependent dividers
+ *          (SysTick reload, UART baud) follow SYSCLK.
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#include "test_cases_driver_clock.h"
+#include "test_config.h"
+#include "test_log.h"
+#include "../MCAL/Clock.h"
+#include "../MCAL/Delay.h"
+#include "../MCAL/UART.h"
+
+/*===========================================================================*/
+/*                           REGISTER DEFINITIONS                            */
+/*===========================================================================*/
+
+#define NVIC_ST_RELOAD_R  (*((volatile uint32_t *)0xE000E014u))
+#define UART1_IBRD_R      (*((volatile uint32_t *)0x4000D024u))
+
+/*===========================================================================*/
+/*                           EXPECTED VALUES                                 */
+/*===========================================================================*/
+
+/* 80 MHz: reload = 80000 - 1, IBRD = 80e6 / (16 * 9600) = 520 */
+#define EXP_RELOAD_80MHZ  (79999u)
+#define EXP_IBRD_80MHZ    (520u)
+
+/* 16 MHz: reload = 16000 - 1, IBRD = 104 */
+#define EXP_RELOAD_16MHZ  (15999u)
+#define EXP_IBRD_16MHZ    (104u)
+
+/* 400 MHz / 30 MHz is not an integer divisor */
+#define TEST_BAD_SYSCLK   (30000000u)
+
+/*===========================================================================*/
+/*                           TEST SUITE NAME                                 */
+/*===========================================================================*/
+
+#define CLOCK_SUITE       "Clock"
+
+/*===========================================================================*/
+/*                           TEST IMPLEMENTATIONS                            */
+/*===========================================================================*/
+
+uint8_t Test_Clock_Pll80_RescalesDrivers(void)
+{
+    uint8_t result = TRUE;
+    
+    /* Setup - make sure every listener is registered */
+    UART1_Init(TEST_LOG_UART_BAUDRATE);
+    
+    /* Execute */
+    if (Clock_Init(CLOCK_80MHZ) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify */
+    if (Clock_GetSysClkHz() != CLOCK_80MHZ)
+    {
+        result = FALSE;
+    }
+    
+    if ((NVIC_ST_RELOAD_R != EXP_RELOAD_80MHZ) ||
+        (UART1_IBRD_R != EXP_IBRD_80MHZ))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+uint8_t Test_Clock_Back16_RestoresDrivers(void)
+{
+    uint8_t result = TRUE;
+    
+    /* Execute */
+    if (Clock_Init(CLOCK_16MHZ) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify */
+    if ((NVIC_ST_RELOAD_R != EXP_RELOAD_16MHZ) ||
+        (UART1_IBRD_R != EXP_IBRD_16MHZ))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+uint8_t Test_Clock_Unsupported_Rejected(void)
+{
+    uint8_t result = TRUE;
+    uint32_t before = Clock_GetSysClkHz();
+    
+    /* Execute */
+    if (Clock_Init(TEST_BAD_SYSCLK) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify clock untouched */
+    if (Clock_GetSysClkHz() != before)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+void Test_Clock_RunAll(void)
+{
+    TestLog_SuiteStart(CLOCK_SUITE);
+    
+    TEST_RUN(CLOCK_SUITE, "Pll80_RescalesDrivers", Test_Clock_Pll80_RescalesDrivers);
+    TEST_RUN(CLOCK_SUITE, "Back16_RestoresDrivers", Test_Clock_Back16_RestoresDrivers);
+    TEST_RUN(CLOCK_SUITE, "Unsupported_Rejected", Test_Clock_Unsupported_Rejected);
+    
+    TestLog_SuiteEnd(CLOCK_SUITE);
+}
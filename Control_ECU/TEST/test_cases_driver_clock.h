@@ -0,0 +1,22 @@
+/**
+ * @file    test_cases_driver_clock.h
+ * @brief   Clock Driver Unit Tests - Control ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#ifndef TEST_CASES_DRIVER_CLOCK_H
+#define TEST_CASES_DRIVER_CLOCK_H
+
+#include "../Common/Std_Types.h"
+
+void Test_Clock_RunAll(void);
+
+uint8_t Test_Clock_Pll80_RescalesDrivers(void);
+uint8_t Test_Clock_Back16_RestoresDrivers(void);
+uint8_t Test_Clock_Unsupported_Rejected(void);
+
+#endif /* TEST_CASES_DRIVER_CLOCK_H */
@@ -28,7 +28,7 @@ uint8_t Test_Delay_Init_Completes(void)
     uint8_t result = TRUE;
     
     /* Execute */
-    Delay_Init_16MHz();
+    Delay_Init();
     
     /* If we got here, init completed */
     
@@ -40,7 +40,7 @@ uint8_t Test_Delay_Ms_Works(void)
     uint8_t result = TRUE;
     
     /* Setup */
-    Delay_Init_16MHz();
+    Delay_Init();
     
     /* Execute - 100ms delay should complete */
     Delay_ms(100u);
@@ -0,0 +1,150 @@
+/**
+ * @file    test_cases_driver_kernel.c
+ * @brief   Micro-Kernel Unit Tests Implementation - Control ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * @details Tests task creation checks and stack painting. The kernel is
+ *          never started here: the test build runs from main() on MSP.
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#include "test_cases_driver_kernel.h"
+#include "test_config.h"
+#include "test_log.h"
+#include "../MCAL/Kernel.h"
+
+/*===========================================================================*/
+/*                           TEST CONFIGURATION                              */
+/*===========================================================================*/
+
+#define TEST_STACK_WORDS          (KERNEL_MIN_STACK_WORDS)
+#define TEST_PRIO                 (3u)
+
+/* r4-r11 + EXC_RETURN + 8-word exception frame, +1 word if top realigned */
+#define TEST_FRAME_BYTES          (17u * 4u)
+
+/*===========================================================================*/
+/*                           TEST SUITE NAME                                 */
+/*===========================================================================*/
+
+#define KERNEL_SUITE      "Kernel"
+
+static uint32_t s_stackA[TEST_STACK_WORDS];
+static uint32_t s_stackB[TEST_STACK_WORDS];
+
+static void Test_Kernel_DummyTask(void)
+{
+    for (;;)
+    {
+        /* never started */
+    }
+}
+
+/*===========================================================================*/
+/*                           TEST IMPLEMENTATIONS                            */
+/*===========================================================================*/
+
+uint8_t Test_Kernel_Create_RejectsBadArgs(void)
+{
+    uint8_t result = TRUE;
+    
+    /* Setup */
+    Kernel_Init();
+    
+    /* Execute & Verify */
+    if (Kernel_CreateTask((Kernel_TaskFn)0, TEST_PRIO, s_stackA,
+                          TEST_STACK_WORDS, "A", (Kernel_TaskId *)0) != E_NOT_OK)
+    {
+        result = FALSE;
+    }
+    
+    if (Kernel_CreateTask(Test_Kernel_DummyTask, KERNEL_IDLE_PRIO, s_stackA,
+                          TEST_STACK_WORDS, "A", (Kernel_TaskId *)0) != E_NOT_OK)
+    {
+        result = FALSE;
+    }
+    
+    if (Kernel_CreateTask(Test_Kernel_DummyTask, TEST_PRIO, s_stackA,
+                          TEST_STACK_WORDS - 1u, "A", (Kernel_TaskId *)0) != E_NOT_OK)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+uint8_t Test_Kernel_Create_UniquePriority(void)
+{
+    uint8_t result = TRUE;
+    
+    /* Setup */
+    Kernel_Init();
+    
+    /* Execute & Verify - second task on the same priority is refused */
+    if (Kernel_CreateTask(Test_Kernel_DummyTask, TEST_PRIO, s_stackA,
+                          TEST_STACK_WORDS, "A", (Kernel_TaskId *)0) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    if (Kernel_CreateTask(Test_Kernel_DummyTask, TEST_PRIO, s_stackB,
+                          TEST_STACK_WORDS, "B", (Kernel_TaskId *)0) != E_NOT_OK)
+    {
+        result = FALSE;
+    }
+    
+    if (Kernel_CreateTask(Test_Kernel_DummyTask, TEST_PRIO + 1u, s_stackB,
+                          TEST_STACK_WORDS, "B", (Kernel_TaskId *)0) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    Kernel_Init();
+    
+    return result;
+}
+
+uint8_t Test_Kernel_StackHighWater_InitialFrame(void)
+{
+    uint8_t result = TRUE;
+    Kernel_TaskId id = 0u;
+    uint32_t used;
+    
+    /* Setup */
+    Kernel_Init();
+    
+    /* Execute */
+    if (Kernel_CreateTask(Test_Kernel_DummyTask, TEST_PRIO, s_stackA,
+                          TEST_STACK_WORDS, "A", &id) != E_OK)
+    {
+        result = FALSE;
+    }
+    else
+    {
+        used = Kernel_GetStackHighWater(id);
+        
+        /* Verify - only the initial frame has been written */
+        if ((used < TEST_FRAME_BYTES) || (used > (TEST_FRAME_BYTES + 4u)))
+        {
+            result = FALSE;
+        }
+    }
+    
+    Kernel_Init();
+    
+    return result;
+}
+
+void Test_Kernel_RunAll(void)
+{
+    TestLog_SuiteStart(KERNEL_SUITE);
+    
+    TEST_RUN(KERNEL_SUITE, "Create_RejectsBadArgs", Test_Kernel_Create_RejectsBadArgs);
+    TEST_RUN(KERNEL_SUITE, "Create_UniquePriority", Test_Kernel_Create_UniquePriority);
+    TEST_RUN(KERNEL_SUITE, "StackHighWater_InitialFrame", Test_Kernel_StackHighWater_InitialFrame);
+    
+    TestLog_SuiteEnd(KERNEL_SUITE);
+}
@@ -0,0 +1,22 @@
+/**
+ * @file    test_cases_driver_kernel.h
+ * @brief   Micro-Kernel Unit Tests - Control ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#ifndef TEST_CASES_DRIVER_KERNEL_H
+#define TEST_CASES_DRIVER_KERNEL_H
+
+#include "../Common/Std_Types.h"
+
+void Test_Kernel_RunAll(void);
+
+uint8_t Test_Kernel_Create_RejectsBadArgs(void);
+uint8_t Test_Kernel_Create_UniquePriority(void);
+uint8_t Test_Kernel_StackHighWater_InitialFrame(void);
+
+#endif /* TEST_CASES_DRIVER_KERNEL_H */
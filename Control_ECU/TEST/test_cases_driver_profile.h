@@ -0,0 +1,22 @@
+/**
+ * @file    test_cases_driver_profile.h
+ * @brief   Profiling Zone Unit Tests - Control ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#ifndef TEST_CASES_DRIVER_PROFILE_H
+#define TEST_CASES_DRIVER_PROFILE_H
+
+#include "../Common/Std_Types.h"
+
+void Test_Profile_RunAll(void);
+
+uint8_t Test_Profile_CycleCounter_Runs(void);
+uint8_t Test_Profile_Zone_RecordsStats(void);
+uint8_t Test_Profile_Reset_ClearsZones(void);
+
+#endif /* TEST_CASES_DRIVER_PROFILE_H */
@@ -14,6 +14,12 @@
 #include "test_config.h"
 #include "test_log.h"
 #include "../HAL/RGB_LED.h"
+#include "../MCAL/Delay.h"
+
+/* One 100 ms breath: near half intensity 30 ms in, over by 130 ms */
+#define TEST_BREATHE_MS       (100u)
+#define TEST_MID_WAIT_MS      (30u)
+#define TEST_END_WAIT_MS      (100u)
 
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
@@ -186,6 +192,68 @@ uint8_t Test_RGB_SetColor_White(void)
     return result;
 }
 
+uint8_t Test_RGB_Pattern_RunsInBackground(void)
+{
+    uint8_t result = TRUE;
+    RGB_PatternType p;
+    RGB_ValueType now;
+    
+    /* Setup */
+    RGB_LED_Init();
+    
+    p.kind      = RGB_PATTERN_BREATHE;
+    p.color     = RGB_LED_ColorValue(RGB_RED);
+    p.period_ms = TEST_BREATHE_MS;
+    p.count     = 1u;
+    p.rest      = RGB_LED_ColorValue(RGB_BLUE);
+    
+    /* Bad arguments are refused */
+    if (RGB_LED_Play((const RGB_PatternType *)0) != E_NOT_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Execute - returns while the breath is still running */
+    if ((RGB_LED_Play(&p) != E_OK) || (RGB_LED_IsPlaying() != TRUE))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - red part way up, on the timer output */
+    Delay_ms(TEST_MID_WAIT_MS);
+    now = RGB_LED_GetRgb();
+    
+    if ((now.r == 0u) || (now.r == 255u) || (now.g != 0u) || (now.b != 0u))
+    {
+        result = FALSE;
+    }
+    if ((GPIO_PORTC_AFSEL_R & RGB_RED_PIN) == 0u)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - over, resting on plain GPIO blue */
+    Delay_ms(TEST_END_WAIT_MS);
+    
+    if (RGB_LED_IsPlaying() != FALSE)
+    {
+        result = FALSE;
+    }
+    if ((GPIO_PORTC_DATA_R & RGB_ALL_PINS) != RGB_BLUE_PIN)
+    {
+        result = FALSE;
+    }
+    if ((GPIO_PORTC_AFSEL_R & RGB_ALL_PINS) != 0u)
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    RGB_LED_SetColor(RGB_OFF);
+    
+    return result;
+}
+
 void Test_RGB_RunAll(void)
 {
     TestLog_SuiteStart(RGB_SUITE);
@@ -196,6 +264,7 @@ void Test_RGB_RunAll(void)
     TEST_RUN(RGB_SUITE, "SetColor_Blue", Test_RGB_SetColor_Blue);
     TEST_RUN(RGB_SUITE, "SetColor_Off", Test_RGB_SetColor_Off);
     TEST_RUN(RGB_SUITE, "SetColor_White", Test_RGB_SetColor_White);
+    TEST_RUN(RGB_SUITE, "Pattern_RunsInBackground", Test_RGB_Pattern_RunsInBackground);
     
     TestLog_SuiteEnd(RGB_SUITE);
 }
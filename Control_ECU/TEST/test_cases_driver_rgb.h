@@ -21,5 +21,6 @@ uint8_t Test_RGB_SetColor_Green(void);
 uint8_t Test_RGB_SetColor_Blue(void);
 uint8_t Test_RGB_SetColor_Off(void);
 uint8_t Test_RGB_SetColor_White(void);
+uint8_t Test_RGB_Pattern_RunsInBackground(void);
 
 #endif /* TEST_CASES_DRIVER_RGB_H */
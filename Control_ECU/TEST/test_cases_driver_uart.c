@@ -14,6 +14,7 @@
 #include "test_config.h"
 #include "test_log.h"
 #include "../MCAL/UART.h"
+#include "../MCAL/Delay.h"
 
 /*===========================================================================*/
 /*                           REGISTER DEFINITIONS                            */
@@ -26,6 +27,9 @@
 #define UART_CTL_UARTEN   (0x0001u)
 #define UART_CTL_TXE      (0x0100u)
 #define UART_CTL_RXE      (0x0200u)
+#define UART_CTL_LBE      (0x0080u)
+
+#define TEST_LOOPBACK_WAIT_MS   (5u)    /* > one frame at 9600 baud */
 
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
@@ -33,6 +37,13 @@
 
 #define UART_SUITE        "UART"
 
+static volatile uint8_t s_rx_notified = 0u;
+
+static void Test_UART_OnRx(void)
+{
+    s_rx_notified++;
+}
+
 /*===========================================================================*/
 /*                           TEST IMPLEMENTATIONS                            */
 /*===========================================================================*/
@@ -100,6 +111,47 @@ uint8_t Test_UART_SendByte_Completes(void)
     return result;
 }
 
+uint8_t Test_UART_Loopback_QueuesByte(void)
+{
+    uint8_t result = TRUE;
+    uint8_t b = 0u;
+
+    UART1_Init(9600u);
+    UART1_SetRxNotify(Test_UART_OnRx);
+    s_rx_notified = 0u;
+
+    /* Nothing queued yet */
+    if (UART1_TryReceiveByte(&b) == E_OK)
+    {
+        result = FALSE;
+    }
+
+    /* TX feeds RX internally; UART1_Handler moves the byte to the ring */
+    UART1_CTL_R |= UART_CTL_LBE;
+    UART1_SendByte((uint8_t)'Z');
+    Delay_ms(TEST_LOOPBACK_WAIT_MS);
+    UART1_CTL_R &= ~UART_CTL_LBE;
+
+    if (s_rx_notified == 0u)
+    {
+        result = FALSE;
+    }
+
+    if ((UART1_TryReceiveByte(&b) != E_OK) || (b != (uint8_t)'Z'))
+    {
+        result = FALSE;
+    }
+
+    if (UART1_TryReceiveByte(&b) == E_OK)
+    {
+        result = FALSE;
+    }
+
+    UART1_SetRxNotify((UART1_RxNotifyFn)0);
+
+    return result;
+}
+
 void Test_UART_RunAll(void)
 {
     TestLog_SuiteStart(UART_SUITE);
@@ -107,6 +159,7 @@ void Test_UART_RunAll(void)
     TEST_RUN(UART_SUITE, "Init_SetsControlRegisters", Test_UART_Init_SetsControlRegisters);
     TEST_RUN(UART_SUITE, "Init_SetsBaudRate", Test_UART_Init_SetsBaudRate);
     TEST_RUN(UART_SUITE, "SendByte_Completes", Test_UART_SendByte_Completes);
+    TEST_RUN(UART_SUITE, "Loopback_QueuesByte", Test_UART_Loopback_QueuesByte);
     
     TestLog_SuiteEnd(UART_SUITE);
 }
@@ -18,5 +18,6 @@ void Test_UART_RunAll(void);
 uint8_t Test_UART_Init_SetsControlRegisters(void);
 uint8_t Test_UART_Init_SetsBaudRate(void);
 uint8_t Test_UART_SendByte_Completes(void);
+uint8_t Test_UART_Loopback_QueuesByte(void);
 
 #endif /* TEST_CASES_DRIVER_UART_H */
@@ -46,7 +46,7 @@ uint8_t Test_Sys_FullDoorOpenClose(void)
     /* Initialize all peripherals */
     RGB_LED_Init();
     Motor_Init();
-    Delay_Init_16MHz();
+    Delay_Init();
     
     /* Phase 1: Door Opening */
     TestLog_Info("Phase 1: Opening door");
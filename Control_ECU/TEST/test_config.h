@@ -39,6 +39,9 @@
 #define TEST_UNIT_EEPROM                (1u)
 #define TEST_UNIT_UART                  (1u)
 #define TEST_UNIT_DELAY                 (1u)
+#define TEST_UNIT_CLOCK                 (1u)
+#define TEST_UNIT_PROFILE               (1u)
+#define TEST_UNIT_KERNEL                (1u)
 
 /*===========================================================================*/
 /*                       INTEGRATION TEST SELECTION                          */
@@ -80,6 +83,7 @@
 #define GPIO_PORTC_DATA_R     (*((volatile uint32_t *)0x400063FCu))
 #define GPIO_PORTC_DIR_R      (*((volatile uint32_t *)0x40006400u))
 #define GPIO_PORTC_DEN_R      (*((volatile uint32_t *)0x4000651Cu))
+#define GPIO_PORTC_AFSEL_R    (*((volatile uint32_t *)0x40006420u))
 
 /* RGB LED pins on Port C */
 #define RGB_RED_PIN           (0x20u)  /* PC5 */
@@ -66,7 +66,7 @@ Std_ReturnType TestLog_Init(void)
     if (g_initialized == 0u)
     {
         UART1_Init(TEST_LOG_UART_BAUDRATE);
-        Delay_Init_16MHz();
+        Delay_Init();
         
         g_testStats.total_tests = 0u;
         g_testStats.passed      = 0u;
@@ -20,6 +20,7 @@
 #include "test_config.h"
 
 #include "../MCAL/Delay.h"
+#include "../MCAL/Profile.h"
 #include "../MCAL/UART.h"
 #include "../HAL/RGB_LED.h"
 
@@ -33,7 +34,8 @@ int main(void)
     const TestStats_t *stats;
     
     /* Initialize hardware */
-    Delay_Init_16MHz();
+    Delay_Init();
+    Profile_Init();
     
     /* Initialize RGB LED for status indication */
     RGB_LED_Init();
@@ -45,6 +47,10 @@ int main(void)
     /* Run all tests */
     failedTests = TestRunner_RunAll();
     
+    /* Cycle counts collected by the instrumented drivers */
+    TestLog_Info("Profile zones (cycles):");
+    Profile_Dump(TestLog_Print);
+    
     /* Get final statistics */
     stats = TestLog_GetStats();
     
@@ -18,6 +18,9 @@
 #include "test_cases_driver_eeprom.h"
 #include "test_cases_driver_uart.h"
 #include "test_cases_driver_delay.h"
+#include "test_cases_driver_clock.h"
+#include "test_cases_driver_profile.h"
+#include "test_cases_driver_kernel.h"
 #include "test_cases_integration.h"
 #include "test_cases_system.h"
 
@@ -103,6 +106,30 @@ uint16_t TestRunner_RunUnitTests(void)
     failed += (stats->failed - prev_failed);
 #endif
 
+#if (TEST_UNIT_CLOCK == 1u)
+    stats = TestLog_GetStats();
+    prev_failed = stats->failed;
+    Test_Clock_RunAll();
+    stats = TestLog_GetStats();
+    failed += (stats->failed - prev_failed);
+#endif
+
+#if (TEST_UNIT_PROFILE == 1u)
+    stats = TestLog_GetStats();
+    prev_failed = stats->failed;
+    Test_Profile_RunAll();
+    stats = TestLog_GetStats();
+    failed += (stats->failed - prev_failed);
+#endif
+
+#if (TEST_UNIT_KERNEL == 1u)
+    stats = TestLog_GetStats();
+    prev_failed = stats->failed;
+    Test_Kernel_RunAll();
+    stats = TestLog_GetStats();
+    failed += (stats->failed - prev_failed);
+#endif
+
 #else
     TestLog_Info("Unit tests disabled in configuration");
     (void)stats;
@@ -0,0 +1,27 @@
+#include "../Common/Std_Types.h"
+#include "../MCAL/delay.h"
+#include "LockoutTimer.h"
+
+void LockoutTimer_Start(LockoutTimer *lo, uint8 seconds)
+{
+    lo->start     = Delay_GetTicksMs();
+    lo->period_ms = (uint32)seconds * 1000u;
+    Delay_ArmDeadline(lo->start + lo->period_ms);
+}
+
+boolean LockoutTimer_IsLocked(const LockoutTimer *lo)
+{
+    return ((Delay_GetTicksMs() - lo->start) < lo->period_ms) ? TRUE : FALSE;
+}
+
+uint8 LockoutTimer_SecondsLeft(const LockoutTimer *lo)
+{
+    const uint32 elapsed = Delay_GetTicksMs() - lo->start;
+
+    if (elapsed >= lo->period_ms)
+    {
+        return 0u;
+    }
+
+    return (uint8)(((lo->period_ms - elapsed) + 999u) / 1000u);
+}
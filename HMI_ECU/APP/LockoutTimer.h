@@ -0,0 +1,25 @@
+#ifndef LOCKOUT_TIMER_H_
+#define LOCKOUT_TIMER_H_
+
+#include "../Common/Std_Types.h"
+
+/* Password entry is refused this long after MAX_ATTEMPTS wrong tries */
+#define LOCKOUT_SEC            (20u)
+
+/* One deadline for the whole lockout, so the screen's once-a-second
+ * redraws cannot stretch it */
+typedef struct
+{
+    uint32 start;
+    uint32 period_ms;
+} LockoutTimer;
+
+void LockoutTimer_Start(LockoutTimer *lo, uint8 seconds);
+
+/* TRUE until exactly seconds * 1000 ms after LockoutTimer_Start */
+boolean LockoutTimer_IsLocked(const LockoutTimer *lo);
+
+/* Whole seconds left, rounded up: 1 in the last second, 0 once unlocked */
+uint8 LockoutTimer_SecondsLeft(const LockoutTimer *lo);
+
+#endif /* LOCKOUT_TIMER_H_ */
@@ -0,0 +1,89 @@
+#include "../Common/Std_Types.h"
+#include "../MCAL/delay.h"
+#include "TypeAhead.h"
+
+static Keypad_EventType g_ta_keys[TYPEAHEAD_LEN];
+static uint8            g_ta_head  = 0u;
+static uint8            g_ta_count = 0u;
+
+/* Latest chord, keys == 0 once taken */
+static Keypad_EventType g_ta_chord;
+
+/* While set, presses stamped inside the window are thrown away */
+static boolean g_ta_discard       = FALSE;
+static uint32  g_ta_discard_start = 0u;
+static uint32  g_ta_discard_ms    = 0u;
+
+static void TypeAhead_EndDiscard(void)
+{
+    if ((g_ta_discard != FALSE) && ((Delay_GetTicksMs() - g_ta_discard_start) >= g_ta_discard_ms))
+    {
+        g_ta_discard = FALSE;
+    }
+}
+
+void TypeAhead_Push(const Keypad_EventType *ev)
+{
+    if (ev->kind == KEYPAD_EV_CHORD) { g_ta_chord = *ev; }
+
+    if ((ev->kind == KEYPAD_EV_PRESS) &&
+        ((g_ta_discard == FALSE) || ((ev->time_ms - g_ta_discard_start) >= g_ta_discard_ms)) &&
+        (g_ta_count < TYPEAHEAD_LEN))
+    {
+        g_ta_keys[(g_ta_head + g_ta_count) % TYPEAHEAD_LEN] = *ev;
+        g_ta_count++;
+    }
+
+    TypeAhead_EndDiscard();
+}
+
+void TypeAhead_Flush(uint32 window_ms)
+{
+    g_ta_head  = 0u;
+    g_ta_count = 0u;
+    g_ta_chord.keys = 0u;
+
+    g_ta_discard       = TRUE;
+    g_ta_discard_start = Delay_GetTicksMs();
+    g_ta_discard_ms    = window_ms;
+}
+
+boolean TypeAhead_Take(char *k)
+{
+    const uint32 now = Delay_GetTicksMs();
+
+    TypeAhead_EndDiscard();
+
+    while (g_ta_count > 0u)
+    {
+        const Keypad_EventType *ev = &g_ta_keys[g_ta_head];
+
+        g_ta_head = (uint8)((g_ta_head + 1u) % TYPEAHEAD_LEN);
+        g_ta_count--;
+
+        if ((now - ev->time_ms) <= TYPEAHEAD_MAX_AGE_MS)
+        {
+            *k = ev->key;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+boolean TypeAhead_TakeChord(uint16 keys)
+{
+    if ((g_ta_chord.keys != keys) ||
+        ((Delay_GetTicksMs() - g_ta_chord.time_ms) > TYPEAHEAD_MAX_AGE_MS))
+    {
+        return FALSE;
+    }
+
+    g_ta_chord.keys = 0u;
+    return TRUE;
+}
+
+uint8 TypeAhead_Count(void)
+{
+    return g_ta_count;
+}
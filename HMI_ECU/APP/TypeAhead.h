@@ -0,0 +1,37 @@
+#ifndef TYPE_AHEAD_H_
+#define TYPE_AHEAD_H_
+
+#include "../Common/Std_Types.h"
+#include "../HAL/Keypad.h"
+
+/* Type-ahead: presses taken off the keypad while no screen is reading
+ * keys (a message hold), so a fast user can start the next PIN before
+ * the prompt is back. Bounded; when full the newest press is dropped, as
+ * in the keypad queue, so the digits that are kept stay in order. A
+ * press older than TYPEAHEAD_MAX_AGE_MS is stale and never delivered. */
+#define TYPEAHEAD_LEN          (6u)       /* a 5-digit PIN and 'A' */
+#define TYPEAHEAD_MAX_AGE_MS   (2000u)    /* longest message hold and 500 ms */
+
+typedef enum
+{
+    TA_KEEP = 0,    /* next screen takes the same input: a retry */
+    TA_FLUSH        /* next screen is a menu: old keys would act on it */
+} TypeAheadPolicy;
+
+/* One keypad event; presses are queued, the latest chord is kept and
+ * other kinds are ignored */
+void TypeAhead_Push(const Keypad_EventType *ev);
+
+/* Drops everything held, and presses stamped in the next window_ms */
+void TypeAhead_Flush(uint32 window_ms);
+
+/* Oldest press still fresh, skipping stale ones; FALSE when none */
+boolean TypeAhead_Take(char *k);
+
+/* TRUE if exactly these keys were held down together, recently */
+boolean TypeAhead_TakeChord(uint16 keys);
+
+/* Presses held, stale ones included */
+uint8 TypeAhead_Count(void);
+
+#endif /* TYPE_AHEAD_H_ */
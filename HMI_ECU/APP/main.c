@@ -1,143 +1,431 @@
 #include <stdint.h>
 #include "../Common/Std_Types.h"
 
+#include "../MCAL/Clock.h"
 #include "../MCAL/delay.h"
 #include "../MCAL/UART.h"
+#include "../MCAL/Profile.h"
 #include "../MCAL/ADC.h"
 
 #include "../HAL/LCD.h"
 #include "../HAL/Keypad.h"
 #include "../HAL/Buzzer.h"
 
+#include "LockoutTimer.h"
+#include "TypeAhead.h"
+
 #define PASSWORD_LENGTH        (5u)
 #define MAX_ATTEMPTS           (3u)
 
 #define UART_BAUDRATE          (9600u)
 
-#define LOCKOUT_SEC            (20u)
+/* Full speed for the door, pot and service screens; the crystal once the
+ * menu has sat untouched for SYSCLK_IDLE_AFTER_MS. Every switch relocks
+ * the PLL and retimes each clock listener, UART1 included. */
+#define SYSCLK_BUSY_HZ         (CLOCK_80MHZ)
+#define SYSCLK_IDLE_HZ         (CLOCK_16MHZ)
+#define SYSCLK_IDLE_AFTER_MS   (10000u)
 
 #define TIMEOUT_MIN_SEC        (5u)
 #define TIMEOUT_MAX_SEC        (30u)
-#define ADC_MAX_COUNTS         (4095u)
+
+/* Pot sampling while the timeout screen is up; the driver's IIR then
+ * settles in ~40 ms. After POT_STILL_MS on one value the comparators
+ * watch the knob instead. */
+#define POT_SAMPLE_HZ          (200u)
+#define POT_STILL_MS           (500u)
 
 #define MSG_MS_SHORT           (800u)
 #define MSG_MS_MED             (1200u)
 #define MSG_MS_LONG            (1500u)
 
+#define KEY_BEEP_MS            (80u)
+
+/* Backlight off after this long without a key; any key turns it back on */
+#define BACKLIGHT_IDLE_MS      (30000u)
+
 static uint8 g_timeout_seconds = 10u;
 
 /* ---------- helpers ---------- */
-static void LCD_PrintNumber(uint16 num)
+/* "<prefix><num><suffix>" into line[LCD_COLS + 1], for LCD_BufWriteLine */
+static void Line_Format(char *line, const char *prefix, uint16 num, const char *suffix)
 {
-    char buf[6];
-    uint8 idx = 0u;
+    char  digits[5];
+    uint8 nd  = 0u;
+    uint8 pos = 0u;
 
-    if (num == 0u) { LCD_SendChar('0'); return; }
+    while ((*prefix != '\0') && (pos < LCD_COLS)) { line[pos] = *prefix; pos++; prefix++; }
 
-    while ((num > 0u) && (idx < (uint8)sizeof(buf)))
+    do
     {
-        uint16 digit = (uint16)(num % 10u);
-        buf[idx] = (char)('0' + (char)digit);
-        idx++;
+        digits[nd] = (char)('0' + (char)(num % 10u));
+        nd++;
         num = (uint16)(num / 10u);
+    } while ((num > 0u) && (nd < (uint8)sizeof(digits)));
+
+    while ((nd > 0u) && (pos < LCD_COLS)) { nd--; line[pos] = digits[nd]; pos++; }
+
+    while ((*suffix != '\0') && (pos < LCD_COLS)) { line[pos] = *suffix; pos++; suffix++; }
+
+    line[pos] = '\0';
+}
+
+/* ---------- cooperative flow helpers ----------
+ * Long-running screens are resumable state machines: each *_Step() does
+ * one short slice of work and returns. Waits are deadlines, never Delay_ms,
+ * so the caller keeps polling the keypad and the link in between.
+ */
+typedef enum
+{
+    FLOW_RUNNING = 0,
+    FLOW_DONE
+} FlowStatus;
+
+typedef struct
+{
+    uint32 start;
+    uint32 period;
+} AppTimer;
+
+static void Timer_Start(AppTimer *t, uint32 ms)
+{
+    t->start  = Delay_GetTicksMs();
+    t->period = ms;
+    Delay_ArmDeadline(t->start + ms);
+}
+
+static boolean Timer_Expired(const AppTimer *t)
+{
+    return ((Delay_GetTicksMs() - t->start) >= t->period) ? TRUE : FALSE;
+}
+
+/* Tones, one per kind of event; the buzzer plays them from its timer ISR */
+static const Buzzer_NoteType g_tone_key[]   = { { 2000u, KEY_BEEP_MS } };
+static const Buzzer_NoteType g_tone_tick[]  = { { 2500u, 40u } };
+static const Buzzer_NoteType g_tone_ok[]    = { { 1500u, 70u }, { 2000u, 70u }, { 2600u, 120u } };
+static const Buzzer_NoteType g_tone_error[] = { { 400u, 150u }, { 0u, 70u }, { 400u, 150u }, { 0u, 70u }, { 400u, 250u } };
+
+#define TONE(t)                (t), (uint8)(sizeof(t) / sizeof((t)[0]))
+
+/* Queued behind whatever is playing; dropped if the queue is full */
+static void Beep(const Buzzer_NoteType *tune, uint8 count)
+{
+    (void)Buzzer_Play(tune, count);
+}
+
+/* Link mailbox: replies are latched whenever the loop runs */
+static uint8   g_link_reply   = 0u;
+static boolean g_link_pending = FALSE;
+
+static void Link_Service(void)
+{
+    uint8 b;
+
+    if (UART1_ReceiveByteTimeout(0u, &b) == E_OK)
+    {
+        g_link_reply   = b;
+        g_link_pending = TRUE;
     }
+}
 
-    while (idx > 0u)
+static void Link_Send(uint8 cmd, const char *payload, uint8 len)
+{
+    uint8 i;
+
+    UART1_FlushRx();
+    g_link_pending = FALSE;
+
+    UART1_SendByte(cmd);
+    for (i = 0u; i < len; i++)
     {
-        idx--;
-        LCD_SendChar(buf[idx]);
+        UART1_SendByte((uint8)payload[i]);
     }
 }
 
-static void Password_ReadScreen(const char *title, char *buffer5)
+static boolean Link_TakeReply(uint8 *out)
 {
-    uint8 index = 0u;
+    if (g_link_pending == FALSE) { return FALSE; }
 
-    LCD_Clear();
-    LCD_SetCursor(0u, 0u);
-    LCD_SendString(title);
-    LCD_SetCursor(1u, 0u);
+    *out = g_link_reply;
+    g_link_pending = FALSE;
+    return TRUE;
+}
 
-    for (;;)
+/* Backlight: the change is free when a screen update follows, which a
+ * key press nearly always causes */
+static AppTimer g_backlight_timer;
+
+static void Backlight_Service(void)
+{
+    if ((LCD_GetBacklight() != FALSE) && (Timer_Expired(&g_backlight_timer) != FALSE))
     {
-        char k = Keypad_GetKey();
-        Buzzer_BeepShort();
+        LCD_SetBacklight(FALSE);
+    }
+}
 
-        if ((k >= '0') && (k <= '9'))
-        {
-            if (index < PASSWORD_LENGTH)
-            {
-                buffer5[index] = k;
-                index++;
-                LCD_SendChar('*');
-            }
-        }
-        else if (k == 'B')
-        {
-            index = 0u;
-            LCD_SetCursor(1u, 0u);
-            LCD_SendString("     ");
-            LCD_SetCursor(1u, 0u);
-        }
-        else if (k == 'A')
-        {
-            if (index == PASSWORD_LENGTH) { return; }
+static void Backlight_Wake(void)
+{
+    LCD_SetBacklight(TRUE);
+    Timer_Start(&g_backlight_timer, BACKLIGHT_IDLE_MS);
+}
 
-            LCD_Clear();
-            LCD_SetCursor(0u, 0u);
-            LCD_SendString("Enter 5 digits");
-            Delay_ms(MSG_MS_MED);
+/* Presses nobody is reading yet go to the type-ahead (APP/TypeAhead.c) */
+static void App_CollectKeys(void)
+{
+    Keypad_EventType ev;
 
-            LCD_Clear();
-            LCD_SetCursor(0u, 0u);
-            LCD_SendString(title);
-            LCD_SetCursor(1u, 0u);
-            index = 0u;
-        }
-        else { }
+    while (Keypad_GetEvent(&ev) == E_OK)
+    {
+        Backlight_Wake();
+        TypeAhead_Push(&ev);
     }
 }
 
-static void Lockout_Countdown(uint8 seconds)
+/* Everything typed so far, and what is typed for the next window_ms */
+static void App_FlushKeys(uint32 window_ms)
 {
-    uint8 s;
+    App_CollectKeys();
+    TypeAhead_Flush(window_ms);
+}
 
-    LCD_Clear();
-    LCD_SetCursor(0u, 0u);
-    LCD_SendString("LOCKOUT");
+/* Clock_Init retimes I2C0 at once, so a background flush still on the
+ * bus would finish at the wrong SCL rate: App_Service switches between
+ * transfers. main starts at SYSCLK_BUSY_HZ. */
+static boolean g_clock_busy = TRUE;
+static AppTimer g_clock_idle_timer;
 
-    for (s = seconds; s > 0u; s--)
+static void App_ClockBusy(void)
+{
+    g_clock_busy = TRUE;
+}
+
+/* Each menu redraw restarts the idle period, so scrolling stays put */
+static void App_ClockIdle(void)
+{
+    g_clock_busy = FALSE;
+    Timer_Start(&g_clock_idle_timer, SYSCLK_IDLE_AFTER_MS);
+}
+
+static void SysClk_Service(void)
+{
+    uint32 want;
+
+    if (LCD_IsFlushPending() != FALSE) { return; }
+
+    if (g_clock_busy != FALSE) { want = SYSCLK_BUSY_HZ; }
+    else if (Timer_Expired(&g_clock_idle_timer) != FALSE) { want = SYSCLK_IDLE_HZ; }
+    else { return; }
+
+    if (Clock_GetSysClkHz() != want) { (void)Clock_Init(want); }
+}
+
+/* Screens are drawn into the LCD shadow buffer; only changes go out here.
+ * Keys are collected here too: a screen that reads keys calls
+ * App_PollKey first in its step, so only presses nobody asked for pile up. */
+static void App_Service(void)
+{
+    App_CollectKeys();
+    Link_Service();
+    Backlight_Service();
+    SysClk_Service();
+    (void)LCD_Flush();
+}
+
+/* Presses only; releases and holds just keep the backlight up. The
+ * waking key still counts: a swallowed first digit would desync password
+ * entry. */
+static boolean App_PollKey(char *k)
+{
+    App_CollectKeys();
+    return TypeAhead_Take(k);
+}
+
+/* Hold a blocking screen up without losing the keys typed meanwhile */
+static void App_Wait(uint32 ms)
+{
+    AppTimer t;
+
+    Timer_Start(&t, ms);
+    while (Timer_Expired(&t) == FALSE)
+    {
+        App_Service();
+    }
+}
+
+/* Each message says what becomes of the keys typed before it went away:
+ * TA_KEEP hands them to the next screen, TA_FLUSH drops them. */
+static void App_ShowMessage(const char *text, AppTimer *t, uint32 hold_ms, TypeAheadPolicy policy)
+{
+    if (policy == TA_FLUSH) { App_FlushKeys(hold_ms); }
+
+    LCD_BufClear();
+    LCD_BufWrite(0u, 0u, text);
+    Timer_Start(t, hold_ms);
+}
+
+/* ---------- password entry ---------- */
+typedef enum
+{
+    PW_DRAW = 0,
+    PW_INPUT,
+    PW_HINT
+} PwState;
+
+typedef struct
+{
+    const char *title;
+    char       *buffer;
+    uint8       index;
+    PwState     state;
+    AppTimer    timer;
+} PwEntry;
+
+static void PwEntry_Start(PwEntry *pw, const char *title, char *buffer5)
+{
+    pw->title  = title;
+    pw->buffer = buffer5;
+    pw->index  = 0u;
+    pw->state  = PW_DRAW;
+}
+
+static FlowStatus PwEntry_Step(PwEntry *pw)
+{
+    char k;
+
+    switch (pw->state)
     {
-        LCD_SetCursor(1u, 0u);
-        LCD_SendString("Wait: ");
-        LCD_PrintNumber(s);
-        LCD_SendString("s   ");
+        case PW_DRAW:
+            LCD_BufClear();
+            LCD_BufWrite(0u, 0u, pw->title);
+            pw->index = 0u;
+            pw->state = PW_INPUT;
+            break;
+
+        case PW_INPUT:
+            if (App_PollKey(&k) == FALSE) { break; }
+            Beep(TONE(g_tone_key));
+
+            if ((k >= '0') && (k <= '9'))
+            {
+                if (pw->index < PASSWORD_LENGTH)
+                {
+                    pw->buffer[pw->index] = k;
+                    LCD_BufWrite(1u, pw->index, "*");
+                    pw->index++;
+                }
+            }
+            else if (k == 'B')
+            {
+                pw->index = 0u;
+                LCD_BufWriteLine(1u, "");
+            }
+            else if (k == 'A')
+            {
+                if (pw->index == PASSWORD_LENGTH) { return FLOW_DONE; }
 
-        Buzzer_BeepShort();
-        Delay_ms(1000u);
+                App_ShowMessage("Enter 5 digits", &pw->timer, MSG_MS_MED, TA_KEEP);
+                pw->state = PW_HINT;
+            }
+            else { }
+            break;
+
+        case PW_HINT:
+        default:
+            if (Timer_Expired(&pw->timer) != FALSE) { pw->state = PW_DRAW; }
+            break;
     }
 
-    LCD_Clear();
-    LCD_SetCursor(0u, 0u);
-    LCD_SendString("Returning...");
-    Delay_ms(MSG_MS_SHORT);
+    return FLOW_RUNNING;
 }
 
-static uint8 Pot_ReadTimeoutSeconds(void)
+/* Blocking wrapper for the flows that are still run-to-completion */
+static void Password_ReadScreen(const char *title, char *buffer5)
 {
-    uint16 adc = 0u;
-    uint32 scaled;
-    uint8 timeout;
+    PwEntry pw;
 
-    if (ADC_ReadTimeout(200u, &adc) != E_OK) { adc = 0u; }
+    PwEntry_Start(&pw, title, buffer5);
+    while (PwEntry_Step(&pw) == FLOW_RUNNING)
+    {
+        App_Service();
+    }
+}
 
-    scaled  = ((uint32)adc * (uint32)(TIMEOUT_MAX_SEC - TIMEOUT_MIN_SEC)) / (uint32)ADC_MAX_COUNTS;
-    timeout = (uint8)(TIMEOUT_MIN_SEC + (uint8)scaled);
+/* ---------- lockout countdown ---------- */
+typedef enum
+{
+    LO_TICK = 0,
+    LO_WAIT,
+    LO_RETURN
+} LockoutState;
 
-    if (timeout < TIMEOUT_MIN_SEC) { timeout = TIMEOUT_MIN_SEC; }
-    if (timeout > TIMEOUT_MAX_SEC) { timeout = TIMEOUT_MAX_SEC; }
+typedef struct
+{
+    LockoutTimer lock;
+    LockoutState state;
+    AppTimer     timer;     /* next redraw */
+} Lockout;
+
+static void Lockout_Start(Lockout *lo, uint8 seconds)
+{
+    LCD_BufClear();
+    LCD_BufWrite(0u, 0u, "LOCKOUT");
 
-    return timeout;
+    LockoutTimer_Start(&lo->lock, seconds);
+    lo->state = LO_TICK;
+}
+
+static FlowStatus Lockout_Step(Lockout *lo)
+{
+    char line[LCD_COLS + 1u];
+
+    switch (lo->state)
+    {
+        case LO_TICK:
+            Line_Format(line, "Wait: ", LockoutTimer_SecondsLeft(&lo->lock), "s");
+            LCD_BufWriteLine(1u, line);
+
+            Beep(TONE(g_tone_tick));
+            Timer_Start(&lo->timer, 1000u);
+            lo->state = LO_WAIT;
+            break;
+
+        case LO_WAIT:
+            /* The deadline ends it, however late the last redraw ran */
+            if (LockoutTimer_IsLocked(&lo->lock) == FALSE)
+            {
+                App_ShowMessage("Returning...", &lo->timer, MSG_MS_SHORT, TA_FLUSH);
+                lo->state = LO_RETURN;
+            }
+            else if (Timer_Expired(&lo->timer) != FALSE)
+            {
+                lo->state = LO_TICK;
+            }
+            else { }
+            break;
+
+        case LO_RETURN:
+        default:
+            if (Timer_Expired(&lo->timer) != FALSE) { return FLOW_DONE; }
+            break;
+    }
+
+    return FLOW_RUNNING;
+}
+
+/* One level per second; the filter and hysteresis in the driver keep a
+ * still knob on one value, so the screen only changes when it is turned */
+static Std_ReturnType Pot_ReadTimeoutSeconds(uint8 *seconds)
+{
+    uint16 level = 0u;
+
+    /* On a failed read *seconds keeps whatever it held */
+    if (ADC_ReadLevel(200u, (uint16)(TIMEOUT_MAX_SEC - TIMEOUT_MIN_SEC + 1u), &level) != E_OK)
+    {
+        return E_NOT_OK;
+    }
+
+    *seconds = (uint8)(TIMEOUT_MIN_SEC + (uint8)level);
+    return E_OK;
 }
 
 /* ---------- Control link ---------- */
@@ -175,47 +463,112 @@ static void Control_LoadSavedTimeout(void)
 }
 
 /* Verify password (used for open/lock/reset/change) */
-static boolean VerifyPassword_WithAttempts(const char *title)
+typedef enum
+{
+    VP_ENTRY = 0,
+    VP_AWAIT_REPLY,
+    VP_WRONG_HOLD,
+    VP_NO_LINK_HOLD,
+    VP_LOCKOUT
+} VerifyState;
+
+typedef struct
+{
+    const char *title;
+    char        entered[PASSWORD_LENGTH];
+    uint8       attempts;
+    boolean     result;
+    VerifyState state;
+    PwEntry     pw;
+    Lockout     lockout;
+    AppTimer    timer;
+} VerifyFlow;
+
+static void Verify_Start(VerifyFlow *vf, const char *title)
+{
+    vf->title    = title;
+    vf->attempts = 0u;
+    vf->result   = FALSE;
+    vf->state    = VP_ENTRY;
+    PwEntry_Start(&vf->pw, title, vf->entered);
+}
+
+static FlowStatus Verify_Step(VerifyFlow *vf)
 {
-    char entered[PASSWORD_LENGTH];
-    uint8 attempts = 0u;
+    uint8 reply;
 
-    while (attempts < MAX_ATTEMPTS)
+    switch (vf->state)
     {
-        uint8 i;
-        uint8 reply;
+        case VP_ENTRY:
+            if (PwEntry_Step(&vf->pw) == FLOW_DONE)
+            {
+                Link_Send((uint8)'V', vf->entered, PASSWORD_LENGTH);
+                Timer_Start(&vf->timer, 400u);
+                vf->state = VP_AWAIT_REPLY;
+            }
+            break;
 
-        Password_ReadScreen(title, entered);
+        case VP_AWAIT_REPLY:
+            if (Link_TakeReply(&reply) != FALSE)
+            {
+                if (reply == (uint8)'Y')
+                {
+                    vf->result = TRUE;
+                    return FLOW_DONE;
+                }
+
+                vf->attempts++;
+                App_ShowMessage("Wrong Password", &vf->timer, MSG_MS_MED, TA_KEEP);
+                Beep(TONE(g_tone_error));
+                vf->state = VP_WRONG_HOLD;
+            }
+            else if (Timer_Expired(&vf->timer) != FALSE)
+            {
+                App_ShowMessage("No Control ECU", &vf->timer, MSG_MS_MED, TA_FLUSH);
+                vf->state = VP_NO_LINK_HOLD;
+            }
+            else { }
+            break;
 
-        UART1_FlushRx();
-        UART1_SendByte((uint8)'V');
-        for (i = 0u; i < PASSWORD_LENGTH; i++)
-        {
-            UART1_SendByte((uint8)entered[i]);
-        }
+        case VP_WRONG_HOLD:
+            if (Timer_Expired(&vf->timer) == FALSE) { break; }
 
-        if (UART1_ReceiveByteTimeout(400u, &reply) != E_OK)
-        {
-            LCD_Clear();
-            LCD_SetCursor(0u,0u);
-            LCD_SendString("No Control ECU");
-            Delay_ms(MSG_MS_MED);
-            return FALSE;
-        }
+            if (vf->attempts < MAX_ATTEMPTS)
+            {
+                PwEntry_Start(&vf->pw, vf->title, vf->entered);
+                vf->state = VP_ENTRY;
+            }
+            else
+            {
+                Lockout_Start(&vf->lockout, LOCKOUT_SEC);
+                vf->state = VP_LOCKOUT;
+            }
+            break;
 
-        if (reply == (uint8)'Y') { return TRUE; }
+        case VP_NO_LINK_HOLD:
+            if (Timer_Expired(&vf->timer) != FALSE) { return FLOW_DONE; }
+            break;
 
-        attempts++;
+        case VP_LOCKOUT:
+        default:
+            if (Lockout_Step(&vf->lockout) == FLOW_DONE) { return FLOW_DONE; }
+            break;
+    }
 
-        LCD_Clear();
-        LCD_SetCursor(0u, 0u);
-        LCD_SendString("Wrong Password");
-        Buzzer_BeepShort();
-        Delay_ms(MSG_MS_MED);
+    return FLOW_RUNNING;
+}
+
+static boolean VerifyPassword_WithAttempts(const char *title)
+{
+    VerifyFlow vf;
+
+    Verify_Start(&vf, title);
+    while (Verify_Step(&vf) == FLOW_RUNNING)
+    {
+        App_Service();
     }
 
-    Lockout_Countdown(LOCKOUT_SEC);
-    return FALSE;
+    return vf.result;
 }
 
 static void InitialPasswordSetup(void)
@@ -230,7 +583,7 @@ static void InitialPasswordSetup(void)
         uint8 reply;
 
         Password_ReadScreen("Enter Password", first);
-        Delay_ms(250u);
+        App_Wait(250u);
         Password_ReadScreen("Re-enter Pass", confirm);
 
         for (i = 0u; i < PASSWORD_LENGTH; i++)
@@ -243,12 +596,8 @@ static void InitialPasswordSetup(void)
             LCD_Clear();
             LCD_SetCursor(0u, 0u);
             LCD_SendString("Mismatch!");
-            for (i = 0u; i < 3u; i++)
-            {
-                Buzzer_BeepShort();
-                Delay_ms(250u);
-            }
-            Delay_ms(MSG_MS_SHORT);
+            Beep(TONE(g_tone_error));
+            App_Wait(MSG_MS_LONG);
             continue;
         }
 
@@ -264,7 +613,7 @@ static void InitialPasswordSetup(void)
             LCD_Clear();
             LCD_SetCursor(0u,0u);
             LCD_SendString("No Control ECU");
-            Delay_ms(MSG_MS_MED);
+            App_Wait(MSG_MS_MED);
             continue;
         }
 
@@ -273,10 +622,8 @@ static void InitialPasswordSetup(void)
             LCD_Clear();
             LCD_SetCursor(0u, 0u);
             LCD_SendString("Pass Saved");
-            Buzzer_On();
-            Delay_ms(170u);
-            Buzzer_Off();
-            Delay_ms(MSG_MS_MED);
+            Beep(TONE(g_tone_ok));
+            App_Wait(MSG_MS_MED);
 
             Control_LoadSavedTimeout();
             return;
@@ -285,140 +632,284 @@ static void InitialPasswordSetup(void)
         LCD_Clear();
         LCD_SetCursor(0u, 0u);
         LCD_SendString("Save Error");
-        Buzzer_BeepShort();
-        Delay_ms(MSG_MS_MED);
+        Beep(TONE(g_tone_error));
+        App_Wait(MSG_MS_MED);
     }
 }
 
 /* Set timeout: POT used here ONLY, saved in Control EEPROM using 'S' atomically */
-static void SetTimeoutUsingPot(void)
+typedef enum
 {
-    LCD_Clear();
-    LCD_SetCursor(0u, 0u);
-    LCD_SendString("Adjust Timeout");
+    ST_ADJUST = 0,
+    ST_PASSWORD,
+    ST_AWAIT_REPLY,
+    ST_RESULT_HOLD
+} SetTimeoutState;
 
-    for (;;)
-    {
-        uint8 timeout = Pot_ReadTimeoutSeconds();
-        char k;
+typedef struct
+{
+    uint8           timeout;
+    uint8           shown;      /* value on the LCD, 0 = nothing drawn */
+    char            pass[PASSWORD_LENGTH];
+    SetTimeoutState state;
+    PwEntry         pw;
+    AppTimer        timer;
+    AppTimer        still;      /* since the value last moved */
+    boolean         watching;   /* ADC_IsWatching() last step */
+} SetTimeoutFlow;
+
+static void SetTimeout_Start(SetTimeoutFlow *st)
+{
+    LCD_BufClear();
+    LCD_BufWrite(0u, 0u, "Adjust Timeout");
+    (void)ADC_StartContinuous(POT_SAMPLE_HZ);
 
-        LCD_SetCursor(1u, 0u);
-        LCD_SendString("Value: ");
-        LCD_PrintNumber(timeout);
-        LCD_SendString("s   ");
+    st->shown = 0u;
+    st->watching = FALSE;
+    st->state = ST_ADJUST;
+}
 
-        if (Keypad_GetKeyTimeout(50u, &k) != E_OK) { continue; }
-        Buzzer_BeepShort();
+static void SetTimeout_ShowResult(SetTimeoutFlow *st, const char *text, const Buzzer_NoteType *tune, uint8 count)
+{
+    App_ShowMessage(text, &st->timer, MSG_MS_MED, TA_FLUSH);
+    Beep(tune, count);
+    st->state = ST_RESULT_HOLD;
+}
 
-        if (k == 'A')
-        {
-            char pass[PASSWORD_LENGTH];
-            uint8 r;
-            uint8 i;
+static FlowStatus SetTimeout_Step(SetTimeoutFlow *st)
+{
+    char  k;
+    uint8 r;
+    char  payload[PASSWORD_LENGTH + 2u];
+    char  line[LCD_COLS + 1u];
+    uint8 i;
 
-            Password_ReadScreen("Enter Password", pass);
+    switch (st->state)
+    {
+        case ST_ADJUST:
+            /* A still knob costs nothing until it is turned */
+            if (ADC_IsWatching() == FALSE)
+            {
+                /* Just woken: a nudge that stays on the same value must
+                 * not re-arm the watch at once */
+                if (st->watching != FALSE) { Timer_Start(&st->still, POT_STILL_MS); }
+                st->watching = FALSE;
+
+                if (Pot_ReadTimeoutSeconds(&st->timeout) != E_OK)
+                {
+                    /* Keep the last good value; with none yet 'A' is refused */
+                    if (st->shown == 0u) { LCD_BufWriteLine(1u, "ADC Error"); }
+                }
+                /* Only reformat when the value actually moved */
+                else if (st->timeout != st->shown)
+                {
+                    Line_Format(line, "Value: ", st->timeout, "s");
+                    LCD_BufWriteLine(1u, line);
+                    st->shown = st->timeout;
+                    Timer_Start(&st->still, POT_STILL_MS);
+                }
+                else if (Timer_Expired(&st->still) != FALSE)
+                {
+                    st->watching = (ADC_WatchLevel() == E_OK) ? TRUE : FALSE;
+                }
+                else { }
+            }
 
-            UART1_FlushRx();
-            UART1_SendByte((uint8)'S');
+            if (App_PollKey(&k) == FALSE) { break; }
 
-            for (i = 0u; i < PASSWORD_LENGTH; i++)
+            /* No good reading on screen: nothing to save */
+            if ((k == 'A') && (st->shown == 0u))
             {
-                UART1_SendByte((uint8)pass[i]);
+                Beep(TONE(g_tone_error));
+                break;
             }
+            Beep(TONE(g_tone_key));
 
-            UART1_SendByte((uint8)('0' + (timeout / 10u)));
-            UART1_SendByte((uint8)('0' + (timeout % 10u)));
+            if ((k == 'A') || (k == 'B')) { ADC_StopContinuous(); }
 
-            if (UART1_ReceiveByteTimeout(600u, &r) != E_OK)
+            if (k == 'A')
             {
-                LCD_Clear();
-                LCD_SetCursor(0u, 0u);
-                LCD_SendString("Timeout Err");
-                Buzzer_BeepShort();
-                Delay_ms(MSG_MS_MED);
-                return;
+                PwEntry_Start(&st->pw, "Enter Password", st->pass);
+                st->state = ST_PASSWORD;
             }
+            else if (k == 'B')
+            {
+                App_ShowMessage("Canceled", &st->timer, MSG_MS_SHORT, TA_FLUSH);
+                st->state = ST_RESULT_HOLD;
+            }
+            else { }
+            break;
 
-            if (r == (uint8)'K')
+        case ST_PASSWORD:
+            if (PwEntry_Step(&st->pw) == FLOW_DONE)
             {
-                g_timeout_seconds = timeout;
-                LCD_Clear();
-                LCD_SetCursor(0u, 0u);
-                LCD_SendString("Timeout Saved");
-                Buzzer_On();
-                Delay_ms(150u);
-                Buzzer_Off();
-                Delay_ms(MSG_MS_MED);
-                return;
+                for (i = 0u; i < PASSWORD_LENGTH; i++)
+                {
+                    payload[i] = st->pass[i];
+                }
+                payload[PASSWORD_LENGTH]      = (char)('0' + (st->timeout / 10u));
+                payload[PASSWORD_LENGTH + 1u] = (char)('0' + (st->timeout % 10u));
+
+                Link_Send((uint8)'S', payload, (uint8)sizeof(payload));
+                Timer_Start(&st->timer, 600u);
+                st->state = ST_AWAIT_REPLY;
             }
-            else if (r == (uint8)'N')
+            break;
+
+        case ST_AWAIT_REPLY:
+            if (Link_TakeReply(&r) != FALSE)
             {
-                LCD_Clear();
-                LCD_SetCursor(0u, 0u);
-                LCD_SendString("Wrong Password");
-                Buzzer_BeepShort();
-                Delay_ms(MSG_MS_MED);
-                return;
+                if (r == (uint8)'K')
+                {
+                    g_timeout_seconds = st->timeout;
+                    SetTimeout_ShowResult(st, "Timeout Saved", TONE(g_tone_ok));
+                }
+                else if (r == (uint8)'N')
+                {
+                    SetTimeout_ShowResult(st, "Wrong Password", TONE(g_tone_error));
+                }
+                else
+                {
+                    SetTimeout_ShowResult(st, "Timeout Err", TONE(g_tone_error));
+                }
             }
-            else
+            else if (Timer_Expired(&st->timer) != FALSE)
             {
-                LCD_Clear();
-                LCD_SetCursor(0u, 0u);
-                LCD_SendString("Timeout Err");
-                Buzzer_BeepShort();
-                Delay_ms(MSG_MS_MED);
-                return;
+                SetTimeout_ShowResult(st, "Timeout Err", TONE(g_tone_error));
             }
-        }
-        else if (k == 'B')
-        {
-            LCD_Clear();
-            LCD_SetCursor(0u, 0u);
-            LCD_SendString("Canceled");
-            Delay_ms(MSG_MS_SHORT);
-            return;
-        }
-        else { }
+            else { }
+            break;
+
+        case ST_RESULT_HOLD:
+        default:
+            if (Timer_Expired(&st->timer) != FALSE) { return FLOW_DONE; }
+            break;
     }
+
+    return FLOW_RUNNING;
 }
 
-static void OpenDoorFlow(void)
+/* Padlock icons for the door screens (CGRAM, uploaded on first use) */
+static const uint8 g_glyph_unlocked[LCD_GLYPH_ROWS] =
+    { 0x0Eu, 0x10u, 0x10u, 0x1Fu, 0x1Bu, 0x1Bu, 0x1Fu, 0x00u };
+static const uint8 g_glyph_locked[LCD_GLYPH_ROWS] =
+    { 0x0Eu, 0x11u, 0x11u, 0x1Fu, 0x1Bu, 0x1Bu, 0x1Fu, 0x00u };
+
+static void App_BufIcon(uint8 row, uint8 col, const uint8 *glyph)
 {
-    uint8 s;
+    char icon[2];
 
-    if (VerifyPassword_WithAttempts("Enter Password") == FALSE) { return; }
+    icon[0] = LCD_Glyph(glyph);
+    icon[1] = '\0';
+    LCD_BufWrite(row, col, icon);
+}
 
-    UART1_FlushRx();
-    UART1_SendByte((uint8)'O');
+/* Open door: a key press during the auto-lock countdown relocks early */
+typedef enum
+{
+    OD_VERIFY = 0,
+    OD_UNLOCK_MSG,
+    OD_COUNTDOWN,
+    OD_RELOCK_MSG
+} OpenDoorState;
 
-    LCD_Clear();
-    LCD_SetCursor(0u, 0u);
-    LCD_SendString("Door Unlocking");
-    Buzzer_BeepShort();
-    Delay_ms(MSG_MS_MED);
+typedef struct
+{
+    uint8         remaining;
+    OpenDoorState state;
+    VerifyFlow    verify;
+    AppTimer      timer;
+} OpenDoorFlow;
+
+static void OpenDoor_Start(OpenDoorFlow *od)
+{
+    Verify_Start(&od->verify, "Enter Password");
+    od->state = OD_VERIFY;
+}
+
+static void OpenDoor_DrawRemaining(const OpenDoorFlow *od)
+{
+    char line[LCD_COLS + 1u];
+
+    /* Seconds as digits, time left as a bar that drains towards relock.
+     * Bar cells are cached glyphs, so a second costs the digits plus the
+     * one or two cells that changed. */
+    Line_Format(line, "Door Open ", od->remaining, "s");
+    LCD_BufWriteLine(0u, line);
+    App_BufIcon(0u, LCD_COLS - 1u, g_glyph_unlocked);
+
+    LCD_BufProgressBar(1u, 0u, LCD_COLS, od->remaining, g_timeout_seconds);
+}
+
+static void OpenDoor_Relock(OpenDoorFlow *od)
+{
+    Link_Send((uint8)'L', (const char *)0, 0u);
+
+    App_ShowMessage("Relocking Door", &od->timer, MSG_MS_LONG, TA_FLUSH);
+    App_BufIcon(0u, LCD_COLS - 1u, g_glyph_locked);
+    Beep(TONE(g_tone_key));
+    od->state = OD_RELOCK_MSG;
+}
+
+static FlowStatus OpenDoor_Step(OpenDoorFlow *od)
+{
+    char k;
 
-    for (s = g_timeout_seconds; s > 0u; s--)
+    switch (od->state)
     {
-        LCD_Clear();
-        LCD_SetCursor(0u, 0u);
-        LCD_SendString("Door Open");
-        LCD_SetCursor(1u, 0u);
-        LCD_SendString("Auto-lock in ");
-        LCD_PrintNumber(s);
-        LCD_SendString("s");
-
-        Buzzer_BeepShort();
-        Delay_ms(1000u);
-    }
+        case OD_VERIFY:
+            if (Verify_Step(&od->verify) == FLOW_RUNNING) { break; }
+            if (od->verify.result == FALSE) { return FLOW_DONE; }
 
-    UART1_FlushRx();
-    UART1_SendByte((uint8)'L');
+            Link_Send((uint8)'O', (const char *)0, 0u);
 
-    LCD_Clear();
-    LCD_SetCursor(0u, 0u);
-    LCD_SendString("Relocking Door");
-    Buzzer_BeepShort();
-    Delay_ms(MSG_MS_LONG);
+            App_ShowMessage("Door Unlocking", &od->timer, MSG_MS_MED, TA_FLUSH);
+            Beep(TONE(g_tone_ok));
+            od->state = OD_UNLOCK_MSG;
+            break;
+
+        case OD_UNLOCK_MSG:
+            if (Timer_Expired(&od->timer) == FALSE) { break; }
+
+            od->remaining = g_timeout_seconds;
+
+            LCD_BufClear();
+            OpenDoor_DrawRemaining(od);
+
+            Beep(TONE(g_tone_tick));
+            Timer_Start(&od->timer, 1000u);
+            od->state = OD_COUNTDOWN;
+            break;
+
+        case OD_COUNTDOWN:
+            if (App_PollKey(&k) != FALSE)
+            {
+                OpenDoor_Relock(od);
+                break;
+            }
+
+            if (Timer_Expired(&od->timer) == FALSE) { break; }
+
+            if (od->remaining > 1u)
+            {
+                od->remaining--;
+                OpenDoor_DrawRemaining(od);
+                Beep(TONE(g_tone_tick));
+                Timer_Start(&od->timer, 1000u);
+            }
+            else
+            {
+                OpenDoor_Relock(od);
+            }
+            break;
+
+        case OD_RELOCK_MSG:
+        default:
+            if (Timer_Expired(&od->timer) != FALSE) { return FLOW_DONE; }
+            break;
+    }
+
+    return FLOW_RUNNING;
 }
 
 /* ---------- NEW: Change password flow (uses Control 'N') ---------- */
@@ -435,7 +926,7 @@ static void ChangePasswordFlow(void)
     for (;;)
     {
         Password_ReadScreen("New Password", new1);
-        Delay_ms(250u);
+        App_Wait(250u);
         Password_ReadScreen("Re-enter New", new2);
 
         match = TRUE;
@@ -449,8 +940,8 @@ static void ChangePasswordFlow(void)
             LCD_Clear();
             LCD_SetCursor(0u,0u);
             LCD_SendString("Mismatch!");
-            Buzzer_BeepShort();
-            Delay_ms(MSG_MS_MED);
+            Beep(TONE(g_tone_error));
+            App_Wait(MSG_MS_MED);
             continue;
         }
 
@@ -466,7 +957,7 @@ static void ChangePasswordFlow(void)
             LCD_Clear();
             LCD_SetCursor(0u,0u);
             LCD_SendString("No Control ECU");
-            Delay_ms(MSG_MS_MED);
+            App_Wait(MSG_MS_MED);
             return;
         }
 
@@ -475,13 +966,14 @@ static void ChangePasswordFlow(void)
         if (reply == (uint8)'K')
         {
             LCD_SendString("Pass Changed");
+            Beep(TONE(g_tone_ok));
         }
         else
         {
             LCD_SendString("Change Error");
+            Beep(TONE(g_tone_error));
         }
-        Buzzer_BeepShort();
-        Delay_ms(MSG_MS_MED);
+        App_Wait(MSG_MS_MED);
         return;
     }
 }
@@ -501,7 +993,7 @@ static void ResetSystemFlow(void)
         LCD_Clear();
         LCD_SetCursor(0u,0u);
         LCD_SendString("No Control ECU");
-        Delay_ms(MSG_MS_MED);
+        App_Wait(MSG_MS_MED);
         return;
     }
 
@@ -511,10 +1003,8 @@ static void ResetSystemFlow(void)
     if (reply == (uint8)'K')
     {
         LCD_SendString("System Reset");
-        Buzzer_On();
-        Delay_ms(150u);
-        Buzzer_Off();
-        Delay_ms(MSG_MS_SHORT);
+        Beep(TONE(g_tone_ok));
+        App_Wait(MSG_MS_SHORT);
 
         g_timeout_seconds = 10u;
 
@@ -524,8 +1014,54 @@ static void ResetSystemFlow(void)
     else
     {
         LCD_SendString("Reset Error");
-        Buzzer_BeepShort();
-        Delay_ms(MSG_MS_MED);
+        Beep(TONE(g_tone_error));
+        App_Wait(MSG_MS_MED);
+    }
+}
+
+/* Service screen: '*' and '#' held together on the main menu. Driver
+ * counters, 'C' for the supply and temperature, any other key leaves. */
+static void ServiceScreen(void)
+{
+    char line[LCD_COLS + 1u];
+    char k;
+    ADC_SnapshotType snap;
+
+    LCD_BufClear();
+    Line_Format(line, "Key ghosts ", Keypad_GetGhostScans(), "");
+    LCD_BufWriteLine(0u, line);
+    Line_Format(line, "Key drops ", Keypad_GetDroppedEvents(), "");
+    LCD_BufWriteLine(1u, line);
+
+    App_FlushKeys(0u);
+    for (;;)
+    {
+        App_Service();
+
+        if (App_PollKey(&k) == FALSE) { continue; }
+        if (k != 'C') { return; }
+
+        Beep(TONE(g_tone_key));
+        if (ADC_ReadSnapshot(200u, &snap) == E_OK)
+        {
+            Line_Format(line, "Supply ", snap.supply_mv, " mV");
+            LCD_BufWriteLine(0u, line);
+            /* Whole degrees, truncated toward zero like the positive side */
+            if (snap.temp_dc <= -10)
+            {
+                Line_Format(line, "Temp -", (uint16)(-(snap.temp_dc / 10)), " C");
+            }
+            else
+            {
+                Line_Format(line, "Temp ", (uint16)((snap.temp_dc > 0) ? (snap.temp_dc / 10) : 0), " C");
+            }
+            LCD_BufWriteLine(1u, line);
+        }
+        else
+        {
+            LCD_BufWriteLine(0u, "ADC Err");
+            LCD_BufWriteLine(1u, "");
+        }
     }
 }
 
@@ -547,31 +1083,89 @@ static const char *MenuNames[MENU_COUNT] =
     "- Reset System"
 };
 
+/* What the main loop is currently stepping */
+typedef enum
+{
+    ACT_MENU = 0,
+    ACT_OPEN_DOOR,
+    ACT_SET_TIMEOUT
+} MenuActivity;
+
 static void MainMenu(void)
 {
-    MenuId selected = MENU_OPEN;
+    MenuId         selected = MENU_OPEN;
+    boolean        redraw   = TRUE;
+    MenuActivity   activity = ACT_MENU;
+    OpenDoorFlow   open_flow;
+    SetTimeoutFlow timeout_flow;
 
     for (;;)
     {
         char k;
 
-        LCD_Clear();
-        LCD_SetCursor(0u, 0u);
-        LCD_SendString("Main Menu");
-        LCD_SetCursor(1u, 0u);
-        LCD_SendString(MenuNames[selected]);
+        App_Service();
 
-        k = Keypad_GetKey();
-        Buzzer_BeepShort();
+        if (activity == ACT_OPEN_DOOR)
+        {
+            if (OpenDoor_Step(&open_flow) == FLOW_DONE) { activity = ACT_MENU; redraw = TRUE; }
+            continue;
+        }
+
+        if (activity == ACT_SET_TIMEOUT)
+        {
+            if (SetTimeout_Step(&timeout_flow) == FLOW_DONE) { activity = ACT_MENU; redraw = TRUE; }
+            continue;
+        }
+
+        if (redraw != FALSE)
+        {
+            LCD_BufClear();
+            LCD_BufWrite(0u, 0u, "Main Menu");
+            LCD_BufWrite(1u, 0u, MenuNames[selected]);
+            (void)LCD_Flush();
+            redraw = FALSE;
+
+            App_ClockIdle();
+        }
+
+        if (TypeAhead_TakeChord((uint16)(Keypad_KeyMask('*') | Keypad_KeyMask('#'))) != FALSE)
+        {
+            App_ClockBusy();
+            Beep(TONE(g_tone_key));
+            ServiceScreen();
+            redraw = TRUE;
+            continue;
+        }
+
+        if (App_PollKey(&k) == FALSE) { continue; }
+
+        Beep(TONE(g_tone_key));
+        redraw = TRUE;
 
         if (k == 'C') { selected = (MenuId)((selected + 1u) % MENU_COUNT); }
         else if (k == 'D') { selected = (MenuId)((selected + MENU_COUNT - 1u) % MENU_COUNT); }
         else if (k == 'A')
         {
-            if (selected == MENU_OPEN) { OpenDoorFlow(); }
-            else if (selected == MENU_TIMEOUT) { SetTimeoutUsingPot(); }
-            else if (selected == MENU_CHANGE_PASS) { ChangePasswordFlow(); }
-            else { ResetSystemFlow(); }
+            if (selected == MENU_OPEN)
+            {
+                App_ClockBusy();
+                OpenDoor_Start(&open_flow);
+                activity = ACT_OPEN_DOOR;
+            }
+            else if (selected == MENU_TIMEOUT)
+            {
+                App_ClockBusy();
+                SetTimeout_Start(&timeout_flow);
+                activity = ACT_SET_TIMEOUT;
+            }
+            else
+            {
+                if (selected == MENU_CHANGE_PASS) { ChangePasswordFlow(); }
+                else { ResetSystemFlow(); }
+
+                /* Their closing messages are plain delays */
+                App_FlushKeys(0u);
+            }
         }
         else { }
     }
@@ -579,9 +1173,12 @@ static void MainMenu(void)
 
 int main(void)
 {
-    Delay_Init_16MHz();
+    (void)Clock_Init(SYSCLK_BUSY_HZ);
+    Delay_Init();
+    Profile_Init();
 
     LCD_Init();
+    Backlight_Wake();
     Keypad_Init();
     Buzzer_Init();
     ADC_Init();
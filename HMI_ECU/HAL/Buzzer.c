@@ -1,41 +1,240 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
-#include "../MCAL/delay.h"
+#include "../MCAL/Clock.h"
 #include "Buzzer.h"
 
-/* Buzzer on PF2 */
+/* Buzzer on PF2 = M1PWM6 (PWM1 generator 3, output A). A note is a 50 %
+ * square wave at its pitch; Timer3A, one-shot, times its length and the
+ * ISR starts the next one. Nothing waits on the CPU. */
 #define SYSCTL_RCGCGPIO_PORTF_MASK  (1u << 5)
+#define SYSCTL_RCGCPWM_PWM1_MASK    (1u << 1)
+#define SYSCTL_RCGCTIMER_TIMER3_MASK (1u << 3)
 #define BUZZER_PIN_MASK            (1u << 2)
+#define BUZZER_PCTL_MASK           (0x00000F00u)
+#define BUZZER_PCTL_M1PWM6         (0x00000500u)
+
+/* PWM clock = SYSCLK / 64: 16-bit periods reach down to 20 Hz at 80 MHz
+ * and still resolve 4 kHz at 16 MHz */
+#define SYSCTL_RCC_USEPWMDIV_MASK  (1u << 20)
+#define SYSCTL_RCC_PWMDIV_MASK     (0x7u << 17)
+#define SYSCTL_RCC_PWMDIV_64       (0x5u << 17)
+#define BUZZER_PWM_DIV             (64u)
+
+/* Count down; A high at LOAD, low at CMPA going down */
+#define PWM_GENA_HIGH_LOW          (0x0000008Cu)
+#define PWM_CTL_ENABLE_MASK        (1u << 0)
+#define PWM_ENABLE_PWM6_MASK       (1u << 6)
+#define PWM_LOAD_MAX               (0xFFFFu)
+
+#define TIMER_CTL_TAEN_MASK        (1u << 0)
+#define TIMER_CFG_32BIT            (0x0u)
+#define TIMER_TAMR_ONESHOT         (0x1u)
+#define TIMER_TATO_MASK            (1u << 0)
+#define NVIC_EN1_TIMER3A_MASK      (1u << 3)   /* IRQ 35 */
 
 #define BUZZER_BEEP_MS             (80u)
 
+/* Single producer (APP), single consumer (timer ISR) */
+static Buzzer_NoteType s_queue[BUZZER_QUEUE_LEN];
+static volatile uint8_t s_head = 0u;          /* next to play */
+static volatile uint8_t s_tail = 0u;          /* next to write */
+static volatile boolean s_playing = FALSE;    /* a queued note is sounding */
+
+static boolean  s_hold = FALSE;               /* Buzzer_On */
+static volatile uint16_t s_freq_hz = 0u;      /* on the pin now, 0 = quiet */
+static uint32_t s_sysclk_hz = CLOCK_RESET_HZ;
+
+static void Buzzer_SetPitch(uint16_t freq_hz)
+{
+    uint32_t load;
+
+    s_freq_hz = freq_hz;
+
+    if (freq_hz == 0u)
+    {
+        /* Disabled outputs are driven low */
+        PWM1_ENABLE_R &= ~PWM_ENABLE_PWM6_MASK;
+        return;
+    }
+
+    load = (s_sysclk_hz / BUZZER_PWM_DIV) / freq_hz;
+    if (load > PWM_LOAD_MAX) { load = PWM_LOAD_MAX; }
+    if (load < 2u) { load = 2u; }
+
+    PWM1_3_LOAD_R = load - 1u;
+    PWM1_3_CMPA_R = load / 2u;
+    PWM1_ENABLE_R |= PWM_ENABLE_PWM6_MASK;
+}
+
+static void Buzzer_StartTimer(uint32_t ticks)
+{
+    TIMER3_TAILR_R = ticks;
+    TIMER3_TAV_R = ticks;
+    TIMER3_CTL_R |= TIMER_CTL_TAEN_MASK;
+}
+
+/* Next note, or back to the steady tone / silence once the queue is
+ * empty. Timer stopped on entry. */
+static void Buzzer_NextNote(void)
+{
+    Buzzer_NoteType note;
+
+    while (s_head != s_tail)
+    {
+        note = s_queue[s_head];
+        s_head = (uint8_t)((s_head + 1u) % BUZZER_QUEUE_LEN);
+
+        if (note.duration_ms != 0u)
+        {
+            Buzzer_SetPitch(note.freq_hz);
+            Buzzer_StartTimer((s_sysclk_hz / 1000u) * note.duration_ms);
+            s_playing = TRUE;
+            return;
+        }
+    }
+
+    s_playing = FALSE;
+    Buzzer_SetPitch((s_hold == TRUE) ? BUZZER_DEFAULT_HZ : 0u);
+}
+
+/* Same pitch and the same time left at the new rate */
+static void Buzzer_OnClockChange(uint32_t sysclk_hz)
+{
+    uint32_t left_ms;
+
+    /* A timeout that landed first must not end the restarted note */
+    TIMER3_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+    TIMER3_ICR_R = TIMER_TATO_MASK;
+    NVIC_UNPEND1_R = NVIC_EN1_TIMER3A_MASK;
+    left_ms = TIMER3_TAV_R / (s_sysclk_hz / 1000u);
+
+    s_sysclk_hz = sysclk_hz;
+    Buzzer_SetPitch(s_freq_hz);
+
+    if (s_playing == TRUE)
+    {
+        Buzzer_StartTimer(((sysclk_hz / 1000u) * left_ms) + 1u);
+    }
+}
+
 void Buzzer_Init(void)
 {
     SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_PORTF_MASK;
+    SYSCTL_RCGCPWM_R |= SYSCTL_RCGCPWM_PWM1_MASK;
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_TIMER3_MASK;
     (void)SYSCTL_RCGCGPIO_R;
+    (void)SYSCTL_RCGCPWM_R;
+    (void)SYSCTL_RCGCTIMER_R;
+
+    SYSCTL_RCC_R = (SYSCTL_RCC_R & ~SYSCTL_RCC_PWMDIV_MASK) |
+                   (SYSCTL_RCC_USEPWMDIV_MASK | SYSCTL_RCC_PWMDIV_64);
 
+    /* PF2 to the PWM, quiet until a note */
+    PWM1_ENABLE_R &= ~PWM_ENABLE_PWM6_MASK;
     GPIO_PORTF_DIR_R |= BUZZER_PIN_MASK;
     GPIO_PORTF_DEN_R |= BUZZER_PIN_MASK;
-
-    GPIO_PORTF_AFSEL_R &= ~BUZZER_PIN_MASK;
     GPIO_PORTF_AMSEL_R &= ~BUZZER_PIN_MASK;
+    GPIO_PORTF_PCTL_R = (GPIO_PORTF_PCTL_R & ~BUZZER_PCTL_MASK) | BUZZER_PCTL_M1PWM6;
+    GPIO_PORTF_AFSEL_R |= BUZZER_PIN_MASK;
+
+    PWM1_3_CTL_R = 0u;
+    PWM1_3_GENA_R = PWM_GENA_HIGH_LOW;
+    PWM1_3_CTL_R |= PWM_CTL_ENABLE_MASK;
+
+    /* Timer3A: note length */
+    TIMER3_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+    TIMER3_CFG_R = TIMER_CFG_32BIT;
+    TIMER3_TAMR_R = TIMER_TAMR_ONESHOT;
+    TIMER3_ICR_R = TIMER_TATO_MASK;
+    TIMER3_IMR_R |= TIMER_TATO_MASK;
+
+    s_sysclk_hz = Clock_GetSysClkHz();
+    (void)Clock_RegisterListener(Buzzer_OnClockChange);
+
+    s_head = s_tail;
+    s_playing = FALSE;
+    s_hold = FALSE;
+    Buzzer_SetPitch(0u);
 
-    Buzzer_Off();
+    NVIC_EN1_R |= NVIC_EN1_TIMER3A_MASK;
+}
+
+void TIMER3A_Handler(void)
+{
+    TIMER3_ICR_R = TIMER_TATO_MASK;
+    Buzzer_NextNote();
 }
 
 void Buzzer_On(void)
 {
-    GPIO_PORTF_DATA_R |= BUZZER_PIN_MASK;
+    s_hold = TRUE;
+    if (s_playing == FALSE)
+    {
+        Buzzer_SetPitch(BUZZER_DEFAULT_HZ);
+    }
 }
 
 void Buzzer_Off(void)
 {
-    GPIO_PORTF_DATA_R &= ~BUZZER_PIN_MASK;
+    s_hold = FALSE;
+    if (s_playing == FALSE)
+    {
+        Buzzer_SetPitch(0u);
+    }
 }
 
 void Buzzer_BeepShort(void)
 {
-    Buzzer_On();
-    Delay_ms(BUZZER_BEEP_MS);
-    Buzzer_Off();
+    static const Buzzer_NoteType beep = { BUZZER_DEFAULT_HZ, BUZZER_BEEP_MS };
+
+    (void)Buzzer_Play(&beep, 1u);
+}
+
+Std_ReturnType Buzzer_Play(const Buzzer_NoteType *notes, uint8_t count)
+{
+    uint8_t used = (uint8_t)((s_tail + BUZZER_QUEUE_LEN - s_head) % BUZZER_QUEUE_LEN);
+    uint8_t i;
+
+    if ((notes == (const Buzzer_NoteType *)0) || (count > ((BUZZER_QUEUE_LEN - 1u) - used)))
+    {
+        return E_NOT_OK;
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        if (notes[i].duration_ms > BUZZER_NOTE_MAX_MS)
+        {
+            return E_NOT_OK;
+        }
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        s_queue[s_tail] = notes[i];
+        s_tail = (uint8_t)((s_tail + 1u) % BUZZER_QUEUE_LEN);
+    }
+
+    /* Only the Timer3A ISR clears s_playing and APP cannot preempt it:
+     * FALSE means the timer is stopped and no ISR will start a note */
+    if (s_playing == FALSE)
+    {
+        Buzzer_NextNote();
+    }
+
+    return E_OK;
+}
+
+void Buzzer_Stop(void)
+{
+    TIMER3_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+    TIMER3_ICR_R = TIMER_TATO_MASK;
+
+    s_head = s_tail;
+    s_playing = FALSE;
+    Buzzer_SetPitch((s_hold == TRUE) ? BUZZER_DEFAULT_HZ : 0u);
+}
+
+boolean Buzzer_IsPlaying(void)
+{
+    return s_playing;
 }
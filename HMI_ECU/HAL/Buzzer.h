@@ -2,10 +2,39 @@
 #define BUZZER_H_
 
 #include <stdint.h>
+#include "../Common/Std_Types.h"
+
+/* Needs a passive piezo: the pin carries the tone itself */
+#define BUZZER_DEFAULT_HZ       (2000u)
+#define BUZZER_QUEUE_LEN        (16u)   /* one slot stays free */
+#define BUZZER_NOTE_MAX_MS      (10000u)
+
+/* freq_hz 0 is a rest */
+typedef struct
+{
+    uint16_t freq_hz;
+    uint16_t duration_ms;
+} Buzzer_NoteType;
 
 void Buzzer_Init(void);
+
+/* Steady BUZZER_DEFAULT_HZ until Buzzer_Off, under any queued notes */
 void Buzzer_On(void);
 void Buzzer_Off(void);
+
+/* One BUZZER_DEFAULT_HZ note of 80 ms; returns at once */
 void Buzzer_BeepShort(void);
 
+/* Notes go after what is already queued and play from the timer ISR.
+ * All or nothing: E_NOT_OK, and none queued, if they do not all fit or
+ * one is longer than BUZZER_NOTE_MAX_MS. */
+Std_ReturnType Buzzer_Play(const Buzzer_NoteType *notes, uint8_t count);
+
+/* Drops the queue and the note playing */
+void Buzzer_Stop(void);
+boolean Buzzer_IsPlaying(void);
+
+/* Timer3A vector: end of a note */
+void TIMER3A_Handler(void);
+
 #endif /* BUZZER_H_ */
@@ -1,72 +1,162 @@
 #include <stdint.h>
-#include "../MCAL/I2C.h"
 #include "../MCAL/delay.h"
+#include "../MCAL/Profile.h"
 #include "LCD.h"
+#include "LCD_Bus.h"
 
-/* PCF8574 I2C backpack */
-#define LCD_ADDR_7BIT           (0x27u)
-
-#define LCD_BACKLIGHT_MASK      (0x08u) /* P3 */
-#define LCD_EN_MASK             (0x04u) /* P2 */
-#define LCD_RW_MASK             (0x02u) /* P1 (kept 0) */
-#define LCD_RS_MASK             (0x01u) /* P0 */
-
-#define LCD_I2C_TIMEOUT_MS      (20u)
+#define LCD_RECOVER_INTERVAL_MS (1000u)
 
 /* HD44780 commands */
 #define LCD_CMD_CLEAR           (0x01u)
 #define LCD_CMD_HOME            (0x02u)
 #define LCD_CMD_ENTRYMODE       (0x06u)
 #define LCD_CMD_DISPLAY_ON      (0x0Cu)
-#define LCD_CMD_FUNCTION_4BIT   (0x28u)
+#define LCD_CMD_SET_CGRAM       (0x40u)
 #define LCD_CMD_SET_DDRAM       (0x80u)
 
-static Std_ReturnType LCD_WriteExpander(uint8_t data)
+/* Slot n is drawn as code 8 + n (the controller mirrors 0..7 there), so
+ * glyphs can sit in NUL-terminated strings */
+#define LCD_GLYPH_CODE_BASE     (0x08u)
+
+/* Progress bar cells: 5 pixel columns each */
+#define LCD_BAR_STEPS           (5u)
+
+/* What APP wants on screen, and what the panel holds right now */
+static char s_shadow[LCD_ROWS][LCD_COLS];
+static char s_shown[LCD_ROWS][LCD_COLS];
+
+/* Set when a write still fails after the bus's retries. From then on the
+ * panel is left alone (no 20 ms timeout per character) and LCD_Flush
+ * re-initializes it every LCD_RECOVER_INTERVAL_MS until it answers. */
+static volatile boolean s_fault = FALSE;
+static uint32_t s_last_recover_ms = 0u;
+static uint16_t s_recover_count = 0u;
+
+/* CGRAM cache: which bitmap each slot holds and when it was last drawn.
+ * Bitmaps are const tables, so the pointer is the key. */
+static const uint8_t *s_slot_glyph[LCD_CGRAM_SLOTS];
+static uint32_t s_slot_used[LCD_CGRAM_SLOTS];
+static uint32_t s_glyph_clock = 0u;
+static uint16_t s_glyph_uploads = 0u;
+
+/* Bit n: slot n's bitmap has not reached the panel yet. LCD_Flush sends
+ * it ahead of the cells, so drawing glyphs into the buffer never blocks. */
+static uint8_t s_slot_dirty = 0u;
+
+/* Progress bar: 1..5 columns lit, left to right */
+static const uint8_t s_bar_glyphs[LCD_BAR_STEPS][LCD_GLYPH_ROWS] =
 {
-    return I2C0_WriteByte(LCD_ADDR_7BIT, data, LCD_I2C_TIMEOUT_MS);
-}
+    { 0x10u, 0x10u, 0x10u, 0x10u, 0x10u, 0x10u, 0x10u, 0x00u },
+    { 0x18u, 0x18u, 0x18u, 0x18u, 0x18u, 0x18u, 0x18u, 0x00u },
+    { 0x1Cu, 0x1Cu, 0x1Cu, 0x1Cu, 0x1Cu, 0x1Cu, 0x1Cu, 0x00u },
+    { 0x1Eu, 0x1Eu, 0x1Eu, 0x1Eu, 0x1Eu, 0x1Eu, 0x1Eu, 0x00u },
+    { 0x1Fu, 0x1Fu, 0x1Fu, 0x1Fu, 0x1Fu, 0x1Fu, 0x1Fu, 0x00u }
+};
+
+/* Panel cursor; col == LCD_COLS means it ran off the visible line */
+static uint8_t s_cur_row = 0u;
+static uint8_t s_cur_col = 0u;
 
-static void LCD_Strobe(uint8_t data)
+static void LCD_FillBuffer(char buf[LCD_ROWS][LCD_COLS])
 {
-    (void)LCD_WriteExpander((uint8_t)(data | LCD_EN_MASK));
-    Delay_ms(2u);
-    (void)LCD_WriteExpander((uint8_t)(data & (uint8_t)(~LCD_EN_MASK)));
-    Delay_ms(2u);
+    uint8_t r;
+    uint8_t c;
+
+    for (r = 0u; r < LCD_ROWS; r++)
+    {
+        for (c = 0u; c < LCD_COLS; c++)
+        {
+            buf[r][c] = ' ';
+        }
+    }
 }
 
-static void LCD_WriteNibble(uint8_t nibble, boolean rs)
+/* Background flush stream: room for every cell plus one cursor move per
+ * row, i.e. a full redraw in one go */
+static LCD_BusWord s_stream[LCD_BUS_MAX_WORDS];
+static volatile boolean s_async_busy = FALSE;
+
+#define LCD_CELLS               (LCD_ROWS * LCD_COLS)
+
+static uint16_t s_budget_bytes = LCD_FLUSH_BUDGET_DEFAULT;
+static uint32_t s_budget_us = 0u;
+
+/* Cell the next flush starts scanning at, so a screen that keeps changing
+ * near the top cannot starve the cells after it */
+static uint8_t s_flush_next = 0u;
+
+/* Panel state unknown: every cell differs and the cursor must be set */
+static void LCD_InvalidateShown(void)
 {
-    uint8_t data = 0u;
+    uint8_t r;
+    uint8_t c;
 
-    data |= (uint8_t)((nibble & 0x0Fu) << 4);
-    data |= LCD_BACKLIGHT_MASK;
+    for (r = 0u; r < LCD_ROWS; r++)
+    {
+        for (c = 0u; c < LCD_COLS; c++)
+        {
+            s_shown[r][c] = '\0';
+        }
+    }
 
-    if (rs != FALSE)
+    s_cur_row = LCD_ROWS;
+}
+
+/* Bus ISR context, or inside LCD_Bus_Submit */
+static void LCD_OnFlushDone(Std_ReturnType result)
+{
+    if (result != E_OK)
     {
-        data |= LCD_RS_MASK;
+        LCD_InvalidateShown();
+        s_fault = TRUE;
     }
 
-    /* RW kept low */
-    (void)LCD_WriteExpander(data);
-    LCD_Strobe(data);
+    s_async_busy = FALSE;
 }
 
 static void LCD_SendByte(uint8_t value, boolean rs)
 {
-    LCD_WriteNibble((uint8_t)((value >> 4) & 0x0Fu), rs);
-    LCD_WriteNibble((uint8_t)(value & 0x0Fu), rs);
+    LCD_BusWord word = (rs == TRUE) ? (LCD_BusWord)(LCD_BUS_RS | value) : (LCD_BusWord)value;
+
+    if (s_fault == TRUE)
+    {
+        return;
+    }
+
+    if (LCD_Bus_Write(&word, 1u) != E_OK)
+    {
+        s_fault = TRUE;
+    }
+}
+
+static void LCD_WaitReady(boolean slow)
+{
+    /* Nothing reached the panel, so nothing to wait for */
+    if (s_fault == FALSE)
+    {
+        LCD_Bus_WaitReady(slow);
+    }
 }
 
 static void LCD_SendCmd(uint8_t cmd)
 {
     LCD_SendByte(cmd, FALSE);
-    Delay_ms(2u);
+    LCD_WaitReady(FALSE);
 }
 
 void LCD_SendChar(char c)
 {
+    PROFILE_BEGIN(PROF_ZONE_LCD_SENDCHAR);
     LCD_SendByte((uint8_t)c, TRUE);
-    Delay_ms(2u);
+    LCD_WaitReady(FALSE);
+    PROFILE_END(PROF_ZONE_LCD_SENDCHAR);
+
+    if ((s_cur_row < LCD_ROWS) && (s_cur_col < LCD_COLS))
+    {
+        s_shown[s_cur_row][s_cur_col]  = c;
+        s_shadow[s_cur_row][s_cur_col] = c;
+        s_cur_col++;
+    }
 }
 
 void LCD_SendString(const char *str)
@@ -85,8 +175,13 @@ void LCD_SendString(const char *str)
 
 void LCD_Clear(void)
 {
-    LCD_SendCmd(LCD_CMD_CLEAR);
-    Delay_ms(5u);
+    LCD_SendByte(LCD_CMD_CLEAR, FALSE);
+    LCD_WaitReady(TRUE);
+
+    LCD_FillBuffer(s_shown);
+    LCD_FillBuffer(s_shadow);
+    s_cur_row = 0u;
+    s_cur_col = 0u;
 }
 
 void LCD_SetCursor(uint8_t row, uint8_t col)
@@ -95,30 +190,479 @@ void LCD_SetCursor(uint8_t row, uint8_t col)
     uint8_t addr = (uint8_t)(base + col);
 
     LCD_SendCmd((uint8_t)(LCD_CMD_SET_DDRAM | addr));
+
+    s_cur_row = row;
+    s_cur_col = (col < LCD_COLS) ? col : LCD_COLS;
 }
 
-void LCD_Init(void)
+void LCD_BufClear(void)
 {
-    I2C0_Init_100k_16MHz();
-    Delay_ms(50u); /* power-up */
+    LCD_FillBuffer(s_shadow);
+}
 
-    /* Backlight ON */
-    (void)LCD_WriteExpander(LCD_BACKLIGHT_MASK);
-    Delay_ms(10u);
+void LCD_BufWrite(uint8_t row, uint8_t col, const char *str)
+{
+    if ((str == (const char *)0) || (row >= LCD_ROWS))
+    {
+        return;
+    }
+
+    while ((*str != '\0') && (col < LCD_COLS))
+    {
+        s_shadow[row][col] = *str;
+        col++;
+        str++;
+    }
+}
+
+void LCD_BufWriteLine(uint8_t row, const char *str)
+{
+    uint8_t col;
+
+    if ((str == (const char *)0) || (row >= LCD_ROWS))
+    {
+        return;
+    }
+
+    for (col = 0u; col < LCD_COLS; col++)
+    {
+        if (*str != '\0')
+        {
+            s_shadow[row][col] = *str;
+            str++;
+        }
+        else
+        {
+            s_shadow[row][col] = ' ';
+        }
+    }
+}
+
+/* Dirty glyphs at the head of the flush stream, as many as fit: CGRAM
+ * address, then the 8 rows. Leaves the address counter in CGRAM, so the
+ * next cell must set DDRAM. Returns the words used; *sent gets the slots. */
+static uint8_t LCD_StreamGlyphs(uint8_t *sent)
+{
+    uint8_t len = 0u;
+    uint8_t slot;
+    uint8_t i;
+
+    *sent = 0u;
+
+    for (slot = 0u; slot < LCD_CGRAM_SLOTS; slot++)
+    {
+        if (((s_slot_dirty & (uint8_t)(1u << slot)) == 0u) ||
+            (((uint32_t)len + 1u + LCD_GLYPH_ROWS) > LCD_BUS_MAX_WORDS))
+        {
+            continue;
+        }
+
+        s_stream[len] = (LCD_BusWord)(LCD_CMD_SET_CGRAM | (uint8_t)(slot << 3));
+        len++;
+        for (i = 0u; i < LCD_GLYPH_ROWS; i++)
+        {
+            s_stream[len] = (LCD_BusWord)(LCD_BUS_RS | (s_slot_glyph[slot][i] & 0x1Fu));
+            len++;
+        }
+
+        s_slot_dirty &= (uint8_t)~(1u << slot);
+        *sent |= (uint8_t)(1u << slot);
+        s_cur_row = LCD_ROWS;
+
+        if (s_glyph_uploads < 0xFFFFu)
+        {
+            s_glyph_uploads++;
+        }
+    }
+
+    return len;
+}
+
+/* A cell showing a slot whose bitmap is still to go out */
+static boolean LCD_CellWaitsForGlyph(char ch)
+{
+    const uint8_t code = (uint8_t)ch;
+
+    return ((code >= LCD_GLYPH_CODE_BASE) && (code < (LCD_GLYPH_CODE_BASE + LCD_CGRAM_SLOTS)) &&
+            ((s_slot_dirty & (uint8_t)(1u << (code - LCD_GLYPH_CODE_BASE))) != 0u)) ? TRUE : FALSE;
+}
+
+static boolean LCD_SlotOnScreen(uint8_t slot)
+{
+    const char code = (char)(LCD_GLYPH_CODE_BASE + slot);
+    uint8_t r;
+    uint8_t c;
+
+    for (r = 0u; r < LCD_ROWS; r++)
+    {
+        for (c = 0u; c < LCD_COLS; c++)
+        {
+            if (s_shadow[r][c] == code)
+            {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+char LCD_Glyph(const uint8_t *bitmap)
+{
+    uint8_t victim = LCD_CGRAM_SLOTS;
+    uint8_t slot;
+
+    if (bitmap == (const uint8_t *)0)
+    {
+        return ' ';
+    }
+
+    s_glyph_clock++;
+
+    for (slot = 0u; slot < LCD_CGRAM_SLOTS; slot++)
+    {
+        if (s_slot_glyph[slot] == bitmap)
+        {
+            s_slot_used[slot] = s_glyph_clock;
+            return (char)(LCD_GLYPH_CODE_BASE + slot);
+        }
+    }
+
+    /* Free slot first, else the least recently drawn one that is not in
+     * the shadow. Every slot on screen: re-uploading one would change
+     * cells that are already drawn, and no flush would repaint them. */
+    for (slot = 0u; (slot < LCD_CGRAM_SLOTS) && (victim == LCD_CGRAM_SLOTS); slot++)
+    {
+        if (s_slot_glyph[slot] == (const uint8_t *)0)
+        {
+            victim = slot;
+        }
+    }
+
+    if (victim == LCD_CGRAM_SLOTS)
+    {
+        for (slot = 0u; slot < LCD_CGRAM_SLOTS; slot++)
+        {
+            if ((LCD_SlotOnScreen(slot) == FALSE) &&
+                ((victim == LCD_CGRAM_SLOTS) || (s_slot_used[slot] < s_slot_used[victim])))
+            {
+                victim = slot;
+            }
+        }
+    }
+
+    if (victim == LCD_CGRAM_SLOTS)
+    {
+        return ' ';
+    }
+
+    s_slot_glyph[victim] = bitmap;
+    s_slot_used[victim] = s_glyph_clock;
+    s_slot_dirty |= (uint8_t)(1u << victim);
+
+    return (char)(LCD_GLYPH_CODE_BASE + victim);
+}
+
+uint16_t LCD_GetGlyphUploadCount(void)
+{
+    return s_glyph_uploads;
+}
+
+void LCD_BufProgressBar(uint8_t row, uint8_t col, uint8_t width, uint32_t value, uint32_t max)
+{
+    uint32_t lit;
+    uint32_t cell_steps;
+    uint8_t i;
+
+    if ((row >= LCD_ROWS) || (col >= LCD_COLS))
+    {
+        return;
+    }
 
-    /* 4-bit init sequence (HD44780) */
-    LCD_WriteNibble(0x03u, FALSE);
-    Delay_ms(5u);
-    LCD_WriteNibble(0x03u, FALSE);
-    Delay_ms(5u);
-    LCD_WriteNibble(0x03u, FALSE);
-    Delay_ms(5u);
+    if ((uint32_t)col + width > LCD_COLS)
+    {
+        width = (uint8_t)(LCD_COLS - col);
+    }
+
+    if (value > max)
+    {
+        value = max;
+    }
+
+    /* Pixel columns lit, rounded to nearest */
+    lit = (max == 0u) ? 0u : ((value * width * LCD_BAR_STEPS) + (max / 2u)) / max;
 
-    LCD_WriteNibble(0x02u, FALSE); /* 4-bit mode */
-    Delay_ms(5u);
+    for (i = 0u; i < width; i++)
+    {
+        cell_steps = (lit > LCD_BAR_STEPS) ? LCD_BAR_STEPS : lit;
+        lit -= cell_steps;
 
-    LCD_SendCmd(LCD_CMD_FUNCTION_4BIT);
+        s_shadow[row][col + i] = (cell_steps == 0u) ? ' ' : LCD_Glyph(s_bar_glyphs[cell_steps - 1u]);
+    }
+}
+
+/* Power-on style init, leaving both buffers alone. Gives up at the first
+ * write that fails even after the bus's retries and leaves s_fault set. */
+static void LCD_InitController(boolean power_up)
+{
+    uint8_t slot;
+
+    s_fault = FALSE;
+
+    if (power_up == TRUE)
+    {
+        Delay_ms(50u);
+    }
+
+    /* Backlight on, as far as the bus can tell anyone is there */
+    if (LCD_Bus_Probe() != E_OK)
+    {
+        s_fault = TRUE;
+        return;
+    }
+    Delay_ms(10u);
+
+    if (LCD_Bus_Reset() != E_OK)
+    {
+        s_fault = TRUE;
+        return;
+    }
+
+    LCD_SendCmd(LCD_BUS_FUNCTION_SET);
     LCD_SendCmd(LCD_CMD_DISPLAY_ON);
     LCD_SendCmd(LCD_CMD_ENTRYMODE);
-    LCD_Clear();
+    LCD_SendByte(LCD_CMD_CLEAR, FALSE);
+    LCD_WaitReady(TRUE);
+
+    s_cur_row = 0u;
+    s_cur_col = 0u;
+
+    /* CGRAM does not survive a power cycle; the next flush puts cached
+     * glyphs back */
+    for (slot = 0u; slot < LCD_CGRAM_SLOTS; slot++)
+    {
+        if (s_slot_glyph[slot] != (const uint8_t *)0)
+        {
+            s_slot_dirty |= (uint8_t)(1u << slot);
+        }
+    }
+}
+
+/* Re-init in place at the current bus speed. The shadow survives, so the
+ * next flush repaints the screen APP last asked for. */
+static void LCD_Recover(void)
+{
+    s_last_recover_ms = Delay_GetTicksMs();
+
+    LCD_Bus_Init(FALSE);
+    s_async_busy = FALSE;
+
+    LCD_InitController(FALSE);
+    LCD_InvalidateShown();
+    s_flush_next = 0u;
+
+    if ((s_fault == FALSE) && (s_recover_count < 0xFFFFu))
+    {
+        s_recover_count++;
+    }
+}
+
+/* Tighter of the two caps in words, at the current (possibly stepped-down)
+ * speed */
+static uint32_t LCD_FlushBudget(void)
+{
+    uint32_t budget = LCD_BUS_MAX_WORDS;
+    uint32_t by_time;
+
+    if ((s_budget_bytes != 0u) && ((s_budget_bytes / LCD_CELL_BUS_BYTES) < budget))
+    {
+        budget = s_budget_bytes / LCD_CELL_BUS_BYTES;
+    }
+
+    if (s_budget_us != 0u)
+    {
+        by_time = LCD_Bus_WordsIn(s_budget_us);
+        if (by_time < budget)
+        {
+            budget = by_time;
+        }
+    }
+
+    return budget;
+}
+
+void LCD_SetFlushBudget(uint16_t max_bytes, uint32_t max_us)
+{
+    s_budget_bytes = max_bytes;
+    s_budget_us = max_us;
+}
+
+/* The whole stream goes to the bus in one submit, with no busy polling
+ * (the bus paces each word itself).
+ * s_shown and the cursor are updated up front; a failed transfer marks
+ * the panel unknown so the next flush redraws it. */
+uint8_t LCD_Flush(void)
+{
+    uint32_t budget;
+    uint8_t sent = 0u;
+    uint8_t len = 0u;
+    uint8_t need;
+    uint8_t n;
+    uint8_t cell = 0u;
+    uint8_t r;
+    uint8_t c;
+    uint8_t glyphs;
+
+    /* Previous flush still on the bus; its cells are already counted */
+    if (s_async_busy == TRUE)
+    {
+        return 0u;
+    }
+
+    if (s_fault == TRUE)
+    {
+        if ((Delay_GetTicksMs() - s_last_recover_ms) < LCD_RECOVER_INTERVAL_MS)
+        {
+            return 0u;
+        }
+
+        LCD_Recover();
+        if (s_fault == TRUE)
+        {
+            return 0u;
+        }
+    }
+
+    budget = LCD_FlushBudget();
+
+    /* Glyphs first: the cells after them may show them */
+    len = LCD_StreamGlyphs(&glyphs);
+
+    for (n = 0u; n < LCD_CELLS; n++)
+    {
+        cell = (uint8_t)((s_flush_next + n) % LCD_CELLS);
+        r = (uint8_t)(cell / LCD_COLS);
+        c = (uint8_t)(cell % LCD_COLS);
+
+        if (s_shadow[r][c] == s_shown[r][c])
+        {
+            continue;
+        }
+
+        /* Its bitmap did not fit in this stream: the next flush resumes here */
+        if (LCD_CellWaitsForGlyph(s_shadow[r][c]) == TRUE)
+        {
+            break;
+        }
+
+        /* Runs of dirty cells ride the controller's auto-increment */
+        need = ((s_cur_row != r) || (s_cur_col != c)) ? 2u : 1u;
+
+        /* Out of budget (the first cell always goes, so a flush always
+         * makes progress) or buffer: the next flush resumes here */
+        if ((len > 0u) && (((uint32_t)len + need) > budget))
+        {
+            break;
+        }
+
+        if ((s_cur_row != r) || (s_cur_col != c))
+        {
+            s_stream[len] = (LCD_BusWord)(LCD_CMD_SET_DDRAM | ((r == 0u) ? 0x00u : 0x40u) | c);
+            len++;
+            s_cur_row = r;
+            s_cur_col = c;
+        }
+
+        s_stream[len] = (LCD_BusWord)(LCD_BUS_RS | (uint8_t)s_shadow[r][c]);
+        len++;
+        s_shown[r][c] = s_shadow[r][c];
+        s_cur_col++;
+        sent++;
+    }
+
+    s_flush_next = (n < LCD_CELLS) ? cell : 0u;
+
+    s_async_busy = TRUE;
+
+    if (len == 0u)
+    {
+        /* Only a backlight change no cell carried, if that */
+        if (LCD_Bus_SyncBacklight(LCD_OnFlushDone) != E_OK)
+        {
+            s_async_busy = FALSE;
+        }
+
+        return 0u;
+    }
+
+    if (LCD_Bus_Submit(s_stream, len, LCD_OnFlushDone) != E_OK)
+    {
+        /* Queue full: not a panel fault, just try again next flush */
+        s_async_busy = FALSE;
+        s_slot_dirty |= glyphs;
+        LCD_InvalidateShown();
+        return 0u;
+    }
+
+    return sent;
+}
+
+boolean LCD_IsFlushPending(void)
+{
+    return s_async_busy;
+}
+
+boolean LCD_IsBusyPollActive(void)
+{
+    return LCD_Bus_IsBusyPollActive();
+}
+
+void LCD_SetBacklight(boolean on)
+{
+    LCD_Bus_SetBacklight(on);
+}
+
+boolean LCD_GetBacklight(void)
+{
+    return LCD_Bus_GetBacklight();
+}
+
+boolean LCD_IsHealthy(void)
+{
+    return (s_fault == FALSE) ? TRUE : FALSE;
+}
+
+uint16_t LCD_GetRecoverCount(void)
+{
+    return s_recover_count;
+}
+
+void LCD_Init(void)
+{
+    uint8_t slot;
+
+    /* Fresh start: nothing cached, so nothing to re-upload */
+    for (slot = 0u; slot < LCD_CGRAM_SLOTS; slot++)
+    {
+        s_slot_glyph[slot] = (const uint8_t *)0;
+        s_slot_used[slot] = 0u;
+    }
+    s_slot_dirty = 0u;
+
+    /* Drains any background flush first */
+    LCD_Bus_Init(TRUE);
+    s_async_busy = FALSE;
+    s_flush_next = 0u;
+
+    LCD_InitController(TRUE);
+
+    LCD_FillBuffer(s_shadow);
+    if (s_fault == TRUE)
+    {
+        LCD_InvalidateShown();
+    }
+    else
+    {
+        LCD_FillBuffer(s_shown);
+    }
 }
@@ -4,6 +4,44 @@
 #include <stdint.h>
 #include "../Common/Std_Types.h"
 
+#define LCD_ROWS                (2u)
+#define LCD_COLS                (16u)
+
+/* Panel wiring, picked at build time (-DLCD_BUS=...) behind the same API:
+ *   LCD_BUS_I2C    PCF8574 backpack on I2C0, PB2/PB3
+ *   LCD_BUS_GPIO4  HD44780 direct: RS PA2, EN PA3, D4..D7 PA4..PA7
+ *   LCD_BUS_GPIO8  as GPIO4, plus D0..D3 on PC4..PC7
+ * On the GPIO buses RW is tied to GND, every instruction is timed rather
+ * than polled, the backlight switches on PE5 and LCD_Flush returns only
+ * once the cells are out. LCD_BUS_I2C runs at 100 kHz unless built with
+ * -DLCD_I2C_FAST=1 (400 kHz, for backpacks known to keep up). */
+#define LCD_BUS_I2C             (0u)
+#define LCD_BUS_GPIO4           (1u)
+#define LCD_BUS_GPIO8           (2u)
+
+#ifndef LCD_BUS
+#define LCD_BUS                 LCD_BUS_I2C
+#endif
+
+/* Flush budget units one cell costs: expander bytes, or EN strobes */
+#if (LCD_BUS == LCD_BUS_I2C)
+#define LCD_CELL_BUS_BYTES      (6u)
+#elif (LCD_BUS == LCD_BUS_GPIO4)
+#define LCD_CELL_BUS_BYTES      (2u)
+#elif (LCD_BUS == LCD_BUS_GPIO8)
+#define LCD_CELL_BUS_BYTES      (1u)
+#else
+#error "LCD_BUS must be LCD_BUS_I2C, LCD_BUS_GPIO4 or LCD_BUS_GPIO8"
+#endif
+
+#define LCD_CGRAM_SLOTS         (8u)
+#define LCD_GLYPH_ROWS          (8u)    /* 5x8: bits 4..0 of each row */
+
+/* Bus bytes per LCD_Flush out of reset: ~1.6 ms of bus at 400 kHz, 6.5 ms
+ * at 100 kHz, so a full redraw trickles out over three or four passes.
+ * The same 72 is 36 cells (~1.5 ms) on GPIO4 and a whole screen on GPIO8. */
+#define LCD_FLUSH_BUDGET_DEFAULT (72u)
+
 void LCD_Init(void);
 void LCD_Clear(void);
 void LCD_SetCursor(uint8_t row, uint8_t col);
@@ -11,4 +49,53 @@ void LCD_SetCursor(uint8_t row, uint8_t col);
 void LCD_SendChar(char c);
 void LCD_SendString(const char *str);
 
+/* TRUE while waits poll the HD44780 busy flag, FALSE on timed fallback
+ * (always on the GPIO buses) */
+boolean LCD_IsBusyPollActive(void);
+
+/* The backlight is switched, not dimmed. Over the PCF8574 the new level
+ * rides on the next expander write; if none comes within 20 ms, LCD_Flush
+ * sends it as a single byte. The GPIO buses switch PE5 at once. */
+void LCD_SetBacklight(boolean on);
+boolean LCD_GetBacklight(void);
+
+/* FALSE after a write failed past I2C0's retries (never on GPIO). Writes then only touch
+ * the buffers and LCD_Flush re-initializes the panel once a second,
+ * repainting the shadow when it answers. */
+boolean LCD_IsHealthy(void);
+uint16_t LCD_GetRecoverCount(void);
+
+/* Shadow framebuffer: these only touch RAM, LCD_Flush() sends the cells
+ * that differ from what the panel shows. The direct calls above write
+ * through to it, so the two styles can be mixed screen by screen. */
+void LCD_BufClear(void);
+void LCD_BufWrite(uint8_t row, uint8_t col, const char *str);   /* clipped at col 15 */
+void LCD_BufWriteLine(uint8_t row, const char *str);            /* space-padded to 16 */
+
+/* Queues the dirty cells, up to the flush budget, as one background I2C
+ * transaction and returns the number queued (0 while the previous flush
+ * is still on the bus).
+ * Direct calls wait for it to finish before touching the panel. The GPIO
+ * buses write the cells before returning (~42 us each). */
+uint8_t LCD_Flush(void);
+
+boolean LCD_IsFlushPending(void);
+
+/* Caps what one LCD_Flush puts on the bus, in bus bytes
+ * (LCD_CELL_BUS_BYTES per cell, twice that with a cursor move) and/or
+ * microseconds at the current bus speed; 0 = no cap. The tighter one wins, at least one cell always goes, and
+ * the next flush resumes at the first cell left over. */
+void LCD_SetFlushBudget(uint16_t max_bytes, uint32_t max_us);
+
+/* Custom characters. bitmap must be a const table (the cache keys on its
+ * address); returns the character to put in buffers or strings. A miss
+ * takes the least recently drawn CGRAM slot not on screen, and the next
+ * LCD_Flush uploads it ahead of the cells; ' ' if every slot is on screen.
+ * The upload count goes up as glyphs are flushed. */
+char LCD_Glyph(const uint8_t *bitmap);
+uint16_t LCD_GetGlyphUploadCount(void);
+
+/* width cells filled in proportion to value/max, 5 steps per cell */
+void LCD_BufProgressBar(uint8_t row, uint8_t col, uint8_t width, uint32_t value, uint32_t max);
+
 #endif /* LCD_H_ */
@@ -0,0 +1,58 @@
+#ifndef LCD_BUS_H_
+#define LCD_BUS_H_
+
+#include <stdint.h>
+#include "../Common/Std_Types.h"
+#include "LCD.h"
+
+/* How LCD.c reaches the HD44780, one implementation per LCD_BUS:
+ * LCD_Pcf8574.c for LCD_BUS_I2C, LCD_Parallel.c for the GPIO buses. Both
+ * are in the project; the one not selected compiles to nothing. */
+
+#if (LCD_BUS == LCD_BUS_GPIO8)
+#define LCD_BUS_FUNCTION_SET    (0x38u)     /* 8-bit, 2 lines, 5x8 */
+#else
+#define LCD_BUS_FUNCTION_SET    (0x28u)     /* 4-bit, 2 lines, 5x8 */
+#endif
+
+/* One HD44780 write: the byte, with RS in bit 8 */
+typedef uint16_t LCD_BusWord;
+#define LCD_BUS_RS              (0x100u)
+
+/* Longest stream: every cell plus one cursor move per row */
+#define LCD_BUS_MAX_WORDS       (LCD_ROWS * (LCD_COLS + 1u))
+
+typedef void (*LCD_BusDoneType)(Std_ReturnType result);
+
+/* Peripheral and pins. first == FALSE is a re-init after a fault: unstick
+ * the bus and keep its current speed. */
+void LCD_Bus_Init(boolean first);
+
+/* E_OK once the panel's side of the bus answers */
+Std_ReturnType LCD_Bus_Probe(void);
+
+/* Reset by instruction up to the bus width; LCD_BUS_FUNCTION_SET next */
+Std_ReturnType LCD_Bus_Reset(void);
+
+/* Back to back, each word given the 37 us a plain instruction takes */
+Std_ReturnType LCD_Bus_Write(const LCD_BusWord *words, uint8_t count);
+
+/* After a write: until the controller is idle. slow = clear or home. */
+void LCD_Bus_WaitReady(boolean slow);
+boolean LCD_Bus_IsBusyPollActive(void);
+
+/* In the background where the bus can; done runs when the words are out,
+ * from the bus ISR or before this returns. Not called on E_NOT_OK. */
+Std_ReturnType LCD_Bus_Submit(const LCD_BusWord *words, uint8_t count, LCD_BusDoneType done);
+
+/* Words that fit in us at the current speed */
+uint32_t LCD_Bus_WordsIn(uint32_t us);
+
+void LCD_Bus_SetBacklight(boolean on);
+boolean LCD_Bus_GetBacklight(void);
+
+/* Sends a backlight change no write has carried for 20 ms on its own;
+ * E_OK if it started, done follows as for Submit */
+Std_ReturnType LCD_Bus_SyncBacklight(LCD_BusDoneType done);
+
+#endif /* LCD_BUS_H_ */
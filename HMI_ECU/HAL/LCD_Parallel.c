@@ -0,0 +1,212 @@
+#include <stdint.h>
+#include "TM4C123GH6PM.h"
+#include "../MCAL/delay.h"
+#include "LCD_Bus.h"
+
+#if (LCD_BUS == LCD_BUS_GPIO4) || (LCD_BUS == LCD_BUS_GPIO8)
+
+#define SYSCTL_RCGCGPIO_PORTA_MASK  (1u << 0)
+#define SYSCTL_RCGCGPIO_PORTC_MASK  (1u << 2)
+#define SYSCTL_RCGCGPIO_PORTE_MASK  (1u << 4)
+
+/* GPIODATA aliases: address bits 9..2 mask the store, so the LCD's pins
+ * change in one write and the rest of the port is left alone without a
+ * read-modify-write (APB apertures) */
+#define LCD_GPIOA_BASE              (0x40004000u)
+#define LCD_GPIOC_BASE              (0x40006000u)
+#define LCD_GPIOE_BASE              (0x40024000u)
+#define LCD_GPIO_DATA(base, mask)   (*((volatile uint32_t *)((base) + ((uint32_t)(mask) << 2))))
+
+#define LCD_RS_PIN                  (1u << 2)   /* PA2 */
+#define LCD_EN_PIN                  (1u << 3)   /* PA3 */
+#define LCD_HIGH_PINS               (0xF0u)     /* PA4..PA7 = D4..D7 */
+#define LCD_LOW_PINS                (0xF0u)     /* PC4..PC7 = D0..D3 (GPIO8) */
+#define LCD_BACKLIGHT_PIN           (1u << 5)   /* PE5 */
+
+#define LCD_PORTA_PINS              (LCD_RS_PIN | LCD_EN_PIN | LCD_HIGH_PINS)
+#define LCD_PORTA_PCTL_MASK         (0xFFFFFF00u)
+#define LCD_PORTC_PCTL_MASK         (0xFFFF0000u)
+#define LCD_PORTE_PCTL_MASK         (0x00F00000u)
+
+/* HD44780 timing, RW tied low so nothing is read back:
+ * 1 us RS/data setup before EN and 1 us EN high (450 ns min each way),
+ * 37 us per instruction at 270 kHz plus margin, 1.52 ms for clear/home */
+#define LCD_STROBE_US               (1u)
+#define LCD_EXEC_US                 (40u)
+#define LCD_SLOW_US                 (1640u)
+
+#if (LCD_BUS == LCD_BUS_GPIO8)
+#define LCD_STROBES_PER_WORD        (1u)
+#else
+#define LCD_STROBES_PER_WORD        (2u)
+#endif
+#define LCD_WORD_US                 (LCD_EXEC_US + (LCD_STROBES_PER_WORD * 2u * LCD_STROBE_US))
+
+static boolean s_backlight = TRUE;
+
+static void LCD_Strobe(void)
+{
+    Delay_us(LCD_STROBE_US);
+    LCD_GPIO_DATA(LCD_GPIOA_BASE, LCD_EN_PIN) = LCD_EN_PIN;
+    Delay_us(LCD_STROBE_US);
+    LCD_GPIO_DATA(LCD_GPIOA_BASE, LCD_EN_PIN) = 0u;
+}
+
+/* RS and D4..D7 in one store; EN is outside the mask */
+static void LCD_PutHigh(uint8_t bits, boolean rs)
+{
+    uint32_t value = (uint32_t)bits & LCD_HIGH_PINS;
+
+    if (rs == TRUE)
+    {
+        value |= LCD_RS_PIN;
+    }
+
+    LCD_GPIO_DATA(LCD_GPIOA_BASE, (LCD_RS_PIN | LCD_HIGH_PINS)) = value;
+}
+
+static void LCD_PutWord(LCD_BusWord word)
+{
+    const boolean rs = ((word & LCD_BUS_RS) != 0u) ? TRUE : FALSE;
+
+#if (LCD_BUS == LCD_BUS_GPIO8)
+    LCD_GPIO_DATA(LCD_GPIOC_BASE, LCD_LOW_PINS) = ((uint32_t)word << 4) & LCD_LOW_PINS;
+    LCD_PutHigh((uint8_t)word, rs);
+    LCD_Strobe();
+#else
+    LCD_PutHigh((uint8_t)word, rs);
+    LCD_Strobe();
+    LCD_PutHigh((uint8_t)(word << 4), rs);
+    LCD_Strobe();
+#endif
+}
+
+void LCD_Bus_Init(boolean first)
+{
+    (void)first;
+
+    SYSCTL_RCGCGPIO_R |= (SYSCTL_RCGCGPIO_PORTA_MASK | SYSCTL_RCGCGPIO_PORTE_MASK);
+#if (LCD_BUS == LCD_BUS_GPIO8)
+    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_PORTC_MASK;
+#endif
+    (void)SYSCTL_RCGCGPIO_R;
+
+    /* EN low before the pins drive, so no stray strobe */
+    LCD_GPIO_DATA(LCD_GPIOA_BASE, LCD_PORTA_PINS) = 0u;
+    GPIO_PORTA_DIR_R |= LCD_PORTA_PINS;
+    GPIO_PORTA_DEN_R |= LCD_PORTA_PINS;
+    GPIO_PORTA_AFSEL_R &= ~LCD_PORTA_PINS;
+    GPIO_PORTA_AMSEL_R &= ~LCD_PORTA_PINS;
+    GPIO_PORTA_PCTL_R &= ~LCD_PORTA_PCTL_MASK;
+
+#if (LCD_BUS == LCD_BUS_GPIO8)
+    /* D0..D3 are N and F during the reset sequence: keep them low */
+    LCD_GPIO_DATA(LCD_GPIOC_BASE, LCD_LOW_PINS) = 0u;
+    GPIO_PORTC_DIR_R |= LCD_LOW_PINS;
+    GPIO_PORTC_DEN_R |= LCD_LOW_PINS;
+    GPIO_PORTC_AFSEL_R &= ~LCD_LOW_PINS;
+    GPIO_PORTC_AMSEL_R &= ~LCD_LOW_PINS;
+    GPIO_PORTC_PCTL_R &= ~LCD_PORTC_PCTL_MASK;
+#endif
+
+    GPIO_PORTE_DIR_R |= LCD_BACKLIGHT_PIN;
+    GPIO_PORTE_DEN_R |= LCD_BACKLIGHT_PIN;
+    GPIO_PORTE_AFSEL_R &= ~LCD_BACKLIGHT_PIN;
+    GPIO_PORTE_AMSEL_R &= ~LCD_BACKLIGHT_PIN;
+    GPIO_PORTE_PCTL_R &= ~LCD_PORTE_PCTL_MASK;
+    LCD_Bus_SetBacklight(s_backlight);
+}
+
+/* Nothing can answer with RW tied low */
+Std_ReturnType LCD_Bus_Probe(void)
+{
+    return E_OK;
+}
+
+/* 0x3 three times sets 8-bit mode from any state; 0x2 then drops to 4 */
+Std_ReturnType LCD_Bus_Reset(void)
+{
+    LCD_PutHigh(0x30u, FALSE);
+    LCD_Strobe();
+    Delay_ms(5u);
+
+    LCD_Strobe();
+    Delay_us(LCD_EXEC_US * 4u);
+
+    LCD_Strobe();
+    Delay_us(LCD_EXEC_US);
+
+#if (LCD_BUS == LCD_BUS_GPIO4)
+    LCD_PutHigh(0x20u, FALSE);
+    LCD_Strobe();
+    Delay_us(LCD_EXEC_US);
+#endif
+
+    return E_OK;
+}
+
+Std_ReturnType LCD_Bus_Write(const LCD_BusWord *words, uint8_t count)
+{
+    uint8_t i;
+
+    for (i = 0u; i < count; i++)
+    {
+        LCD_PutWord(words[i]);
+        Delay_us(LCD_EXEC_US);
+    }
+
+    return E_OK;
+}
+
+/* LCD_Bus_Write already waited the plain instruction time */
+void LCD_Bus_WaitReady(boolean slow)
+{
+    if (slow == TRUE)
+    {
+        Delay_us(LCD_SLOW_US - LCD_EXEC_US);
+    }
+}
+
+boolean LCD_Bus_IsBusyPollActive(void)
+{
+    return FALSE;
+}
+
+/* No background engine: the CPU strobes the cells out before returning */
+Std_ReturnType LCD_Bus_Submit(const LCD_BusWord *words, uint8_t count, LCD_BusDoneType done)
+{
+    if ((count == 0u) || (count > LCD_BUS_MAX_WORDS))
+    {
+        return E_NOT_OK;
+    }
+
+    (void)LCD_Bus_Write(words, count);
+    done(E_OK);
+
+    return E_OK;
+}
+
+uint32_t LCD_Bus_WordsIn(uint32_t us)
+{
+    return us / LCD_WORD_US;
+}
+
+void LCD_Bus_SetBacklight(boolean on)
+{
+    s_backlight = on;
+    LCD_GPIO_DATA(LCD_GPIOE_BASE, LCD_BACKLIGHT_PIN) = (on == TRUE) ? LCD_BACKLIGHT_PIN : 0u;
+}
+
+boolean LCD_Bus_GetBacklight(void)
+{
+    return s_backlight;
+}
+
+/* Already switched by LCD_Bus_SetBacklight */
+Std_ReturnType LCD_Bus_SyncBacklight(LCD_BusDoneType done)
+{
+    (void)done;
+    return E_NOT_OK;
+}
+
+#endif /* LCD_BUS == LCD_BUS_GPIO4 || LCD_BUS == LCD_BUS_GPIO8 */
@@ -0,0 +1,340 @@
+#include <stdint.h>
+#include "../MCAL/I2C.h"
+#include "../MCAL/delay.h"
+#include "LCD_Bus.h"
+
+#if (LCD_BUS == LCD_BUS_I2C)
+
+/* PCF8574 I2C backpack */
+#define LCD_ADDR_7BIT           (0x27u)
+
+#define LCD_BACKLIGHT_MASK      (0x08u) /* P3 */
+#define LCD_EN_MASK             (0x04u) /* P2 */
+#define LCD_RW_MASK             (0x02u) /* P1 (high only to read busy flag) */
+#define LCD_RS_MASK             (0x01u) /* P0 */
+#define LCD_DATA_MASK           (0xF0u) /* P4..P7 = D4..D7 */
+#define LCD_BUSY_FLAG_MASK      (0x80u) /* D7 in the high nibble read */
+
+#define LCD_I2C_TIMEOUT_MS      (20u)
+
+/* The PCF8574 is rated for 100 kHz, so that is the default. Build with
+ * LCD_I2C_FAST=1 for a backpack known to run at 400 kHz (many do): bus
+ * time drops 4x, and I2C0 still steps down to 100 kHz if it fails. Never
+ * Fast-mode Plus: three 9 us bytes between strobes would undercut the
+ * 37 us a character needs on the background flush path. */
+#ifndef LCD_I2C_FAST
+#define LCD_I2C_FAST            (0)
+#endif
+
+#if (LCD_I2C_FAST == 1)
+#define LCD_I2C_SPEED_HZ        (I2C0_SPEED_FAST_HZ)
+#else
+#define LCD_I2C_SPEED_HZ        (I2C0_SPEED_STANDARD_HZ)
+#endif
+#define LCD_PROBE_TRIES         (2u * I2C0_STEPDOWN_FAILURES)
+
+/* How long a backlight change waits for a data write to carry it before
+ * LCD_Flush sends it as a lone byte */
+#define LCD_BACKLIGHT_LAZY_MS   (20u)
+
+/* Worst-case waits, used until the busy flag has been read successfully
+ * and again for good if the read path ever fails */
+#define LCD_CMD_WAIT_MS         (2u)
+#define LCD_CLEAR_WAIT_MS       (7u)
+#define LCD_BUSY_TIMEOUT_MS     (10u)   /* clear/home take 1.52 ms */
+
+/* Expander bytes per nibble: data, EN high, EN low */
+#define LCD_NIBBLE_BYTES        (3u)
+#define LCD_BYTE_BYTES          (2u * LCD_NIBBLE_BYTES)
+#define LCD_SCL_CLOCKS_PER_BYTE (9u)
+
+/* Blocking writes are split into bursts of this many words (a glyph) */
+#define LCD_WRITE_CHUNK_WORDS   (1u + LCD_GLYPH_ROWS)
+
+/* Background stream: a full redraw in one transaction (204 bytes) */
+#define LCD_ASYNC_BYTES         (LCD_BUS_MAX_WORDS * LCD_BYTE_BYTES)
+
+static uint8_t s_async_buf[LCD_ASYNC_BYTES];
+
+/* TRUE once in 4-bit mode; dropped for good if a busy read fails */
+static boolean s_busy_poll = FALSE;
+
+/* P3 level ORed into every expander byte. A change only goes out with the
+ * next byte written; s_backlight_dirty until then. */
+static uint8_t s_backlight = LCD_BACKLIGHT_MASK;
+static boolean s_backlight_dirty = FALSE;
+static uint32_t s_backlight_changed_ms = 0u;
+
+/* Each expander byte takes >= 22 us on the bus at 400 kHz, far longer
+ * than the HD44780's 40 ns setup and 230 ns EN pulse, so the bus paces the
+ * strobe and no delays are needed inside a transaction. */
+static void LCD_PackNibble(uint8_t *out, uint8_t nibble, boolean rs)
+{
+    uint8_t data = 0u;
+
+    data |= (uint8_t)((nibble & 0x0Fu) << 4);
+    data |= s_backlight;
+    s_backlight_dirty = FALSE;
+
+    if (rs != FALSE)
+    {
+        data |= LCD_RS_MASK;
+    }
+
+    /* RW kept low */
+    out[0] = data;
+    out[1] = (uint8_t)(data | LCD_EN_MASK);
+    out[2] = (uint8_t)(data & (uint8_t)(~LCD_EN_MASK));
+}
+
+static void LCD_PackWord(uint8_t *out, LCD_BusWord word)
+{
+    const boolean rs = ((word & LCD_BUS_RS) != 0u) ? TRUE : FALSE;
+
+    LCD_PackNibble(&out[0], (uint8_t)((word >> 4) & 0x0Fu), rs);
+    LCD_PackNibble(&out[LCD_NIBBLE_BYTES], (uint8_t)(word & 0x0Fu), rs);
+}
+
+static Std_ReturnType LCD_WriteNibble(uint8_t nibble)
+{
+    uint8_t seq[LCD_NIBBLE_BYTES];
+
+    LCD_PackNibble(seq, nibble, FALSE);
+    return I2C0_WriteBurst(LCD_ADDR_7BIT, seq, LCD_NIBBLE_BYTES, LCD_I2C_TIMEOUT_MS);
+}
+
+/* RW high with D4..D7 written high, so the PCF8574's weak pull-ups let
+ * the controller drive them. 4-bit mode returns BF/AC as two nibbles:
+ * the first EN pulse is sampled, the second is clocked out and dropped.
+ * Needs RW wired to P1, as on the common backpacks. */
+static Std_ReturnType LCD_ReadBusy(boolean *busy)
+{
+    const uint8_t idle = (uint8_t)(LCD_DATA_MASK | LCD_RW_MASK | s_backlight);
+    const uint8_t raise[2]  = { idle, (uint8_t)(idle | LCD_EN_MASK) };
+    const uint8_t finish[3] = { idle, (uint8_t)(idle | LCD_EN_MASK), idle };
+    uint8_t pins = LCD_BUSY_FLAG_MASK;
+    Std_ReturnType ret;
+
+    ret = I2C0_WriteBurst(LCD_ADDR_7BIT, raise, 2u, LCD_I2C_TIMEOUT_MS);
+    if (ret == E_OK)
+    {
+        ret = I2C0_ReadByte(LCD_ADDR_7BIT, &pins, LCD_I2C_TIMEOUT_MS);
+    }
+
+    /* Always finish the second nibble so the controller stays in step */
+    if (I2C0_WriteBurst(LCD_ADDR_7BIT, finish, 3u, LCD_I2C_TIMEOUT_MS) != E_OK)
+    {
+        ret = E_NOT_OK;
+    }
+
+    *busy = ((pins & LCD_BUSY_FLAG_MASK) != 0u) ? TRUE : FALSE;
+    return ret;
+}
+
+void LCD_Bus_Init(boolean first)
+{
+    /* Both drain any background flush first */
+    if (first == TRUE)
+    {
+        (void)I2C0_Init(LCD_I2C_SPEED_HZ);
+    }
+    else
+    {
+        (void)I2C0_BusRecover();
+        (void)I2C0_Init(I2C0_GetSpeedHz());
+    }
+
+    s_busy_poll = FALSE;
+}
+
+/* Backlight byte; repeated NACKs here walk the bus down to a rate the
+ * expander answers at */
+Std_ReturnType LCD_Bus_Probe(void)
+{
+    uint8_t tries;
+
+    s_busy_poll = FALSE;
+
+    for (tries = 0u; tries < LCD_PROBE_TRIES; tries++)
+    {
+        if (I2C0_WriteByte(LCD_ADDR_7BIT, s_backlight, LCD_I2C_TIMEOUT_MS) == E_OK)
+        {
+            s_backlight_dirty = FALSE;
+            return E_OK;
+        }
+    }
+
+    return E_NOT_OK;
+}
+
+/* 4-bit init sequence (HD44780) */
+Std_ReturnType LCD_Bus_Reset(void)
+{
+    static const uint8_t nibbles[4] = { 0x03u, 0x03u, 0x03u, 0x02u };
+    uint8_t i;
+
+    s_busy_poll = FALSE;
+
+    for (i = 0u; i < 4u; i++)
+    {
+        if (LCD_WriteNibble(nibbles[i]) != E_OK)
+        {
+            return E_NOT_OK;
+        }
+        Delay_ms(5u);
+    }
+
+    /* BF is only meaningful once the interface width is set */
+    s_busy_poll = TRUE;
+    return E_OK;
+}
+
+/* Bursts of up to a glyph's worth, each one I2C transaction */
+Std_ReturnType LCD_Bus_Write(const LCD_BusWord *words, uint8_t count)
+{
+    uint8_t seq[LCD_WRITE_CHUNK_WORDS * LCD_BYTE_BYTES];
+    uint8_t n;
+    uint8_t i;
+
+    while (count > 0u)
+    {
+        n = (count > LCD_WRITE_CHUNK_WORDS) ? LCD_WRITE_CHUNK_WORDS : count;
+
+        for (i = 0u; i < n; i++)
+        {
+            LCD_PackWord(&seq[i * LCD_BYTE_BYTES], words[i]);
+        }
+
+        if (I2C0_WriteBurst(LCD_ADDR_7BIT, seq, (uint8_t)(n * LCD_BYTE_BYTES), LCD_I2C_TIMEOUT_MS) != E_OK)
+        {
+            return E_NOT_OK;
+        }
+
+        words = &words[n];
+        count = (uint8_t)(count - n);
+    }
+
+    return E_OK;
+}
+
+/* Wait exactly as long as the controller is busy, or the worst case if
+ * the busy flag cannot be read */
+void LCD_Bus_WaitReady(boolean slow)
+{
+    uint32_t start;
+    boolean busy = TRUE;
+
+    if (s_busy_poll == TRUE)
+    {
+        start = Delay_GetTicksMs();
+        Delay_ArmDeadline(start + LCD_BUSY_TIMEOUT_MS);
+
+        do
+        {
+            if (LCD_ReadBusy(&busy) != E_OK)
+            {
+                break;
+            }
+        } while ((busy == TRUE) && ((Delay_GetTicksMs() - start) < LCD_BUSY_TIMEOUT_MS));
+
+        if (busy == FALSE)
+        {
+            return;
+        }
+
+        /* NACK, or BF stuck high (RW not wired): timed waits from now on */
+        s_busy_poll = FALSE;
+    }
+
+    Delay_ms((slow == TRUE) ? LCD_CLEAR_WAIT_MS : LCD_CMD_WAIT_MS);
+}
+
+boolean LCD_Bus_IsBusyPollActive(void)
+{
+    return s_busy_poll;
+}
+
+/* The whole stream goes out as one background transaction, with no busy
+ * polling: at 400 kHz or less each expander byte takes >= 22 us and three
+ * pass before the next strobe, so the 37 us a character or DDRAM move
+ * needs is always over. */
+Std_ReturnType LCD_Bus_Submit(const LCD_BusWord *words, uint8_t count, LCD_BusDoneType done)
+{
+    I2C0_XferType xfer;
+    uint8_t i;
+
+    if ((count == 0u) || (count > LCD_BUS_MAX_WORDS))
+    {
+        return E_NOT_OK;
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        LCD_PackWord(&s_async_buf[i * LCD_BYTE_BYTES], words[i]);
+    }
+
+    xfer.addr = LCD_ADDR_7BIT;
+    xfer.read = FALSE;
+    xfer.buf  = s_async_buf;
+    xfer.len  = (uint8_t)(count * LCD_BYTE_BYTES);
+    xfer.done = done;
+
+    return I2C0_Submit(&xfer);
+}
+
+uint32_t LCD_Bus_WordsIn(uint32_t us)
+{
+    uint32_t bytes = ((I2C0_GetSpeedHz() / 1000u) * us) / (LCD_SCL_CLOCKS_PER_BYTE * 1000u);
+
+    return bytes / LCD_BYTE_BYTES;
+}
+
+void LCD_Bus_SetBacklight(boolean on)
+{
+    uint8_t level = (on == TRUE) ? LCD_BACKLIGHT_MASK : 0u;
+
+    if (level == s_backlight)
+    {
+        return;
+    }
+
+    s_backlight = level;
+    s_backlight_dirty = TRUE;
+    s_backlight_changed_ms = Delay_GetTicksMs();
+    Delay_ArmDeadline(s_backlight_changed_ms + LCD_BACKLIGHT_LAZY_MS);
+}
+
+boolean LCD_Bus_GetBacklight(void)
+{
+    return (s_backlight != 0u) ? TRUE : FALSE;
+}
+
+Std_ReturnType LCD_Bus_SyncBacklight(LCD_BusDoneType done)
+{
+    I2C0_XferType xfer;
+
+    /* Nothing carried the backlight change; send it by itself */
+    if ((s_backlight_dirty == FALSE) ||
+        ((Delay_GetTicksMs() - s_backlight_changed_ms) < LCD_BACKLIGHT_LAZY_MS))
+    {
+        return E_NOT_OK;
+    }
+
+    s_async_buf[0] = s_backlight;
+
+    xfer.addr = LCD_ADDR_7BIT;
+    xfer.read = FALSE;
+    xfer.buf  = s_async_buf;
+    xfer.len  = 1u;
+    xfer.done = done;
+
+    if (I2C0_Submit(&xfer) != E_OK)
+    {
+        return E_NOT_OK;
+    }
+
+    s_backlight_dirty = FALSE;
+    return E_OK;
+}
+
+#endif /* LCD_BUS == LCD_BUS_I2C */
@@ -1,28 +1,83 @@
 #include <stdint.h>
+#include <intrinsics.h>
 #include "TM4C123GH6PM.h"
 #include "../MCAL/delay.h"
+#include "../MCAL/Clock.h"
+#include "../MCAL/Profile.h"
 #include "Keypad.h"
 
-/* Rows: PD0..PD3 output
+/* Rows: PD0..PD3 open-drain output, so two keys in one column never
+ *       short a high row to a low one
  * Cols: PE1..PE4 input with pull-ups
+ *
+ * Idle, all rows sit low so any key pulls its column down and raises a
+ * falling-edge interrupt. That starts Timer2A, whose tick scans the
+ * matrix and steps one debounce state machine per key. Once every key
+ * is back up the timer stops and the column interrupts are re-armed.
  */
 #define SYSCTL_RCGCGPIO_PORTD_MASK     (1u << 3)
 #define SYSCTL_RCGCGPIO_PORTE_MASK     (1u << 4)
+#define SYSCTL_RCGCTIMER_TIMER2_MASK   (1u << 2)
 
 #define ROWS_MASK                      (0x0Fu) /* PD0..PD3 */
 #define COLS_MASK                      (0x1Eu) /* PE1..PE4 */
+#define COLS_SHIFT                     (1u)
 
-#define DEBOUNCE_MS                    (20u)
-#define SCAN_SETTLE_MS                 (1u)
+#define NVIC_EN0_GPIOE_MASK            (1u << 4)
+#define NVIC_EN0_TIMER2A_MASK          (1u << 23)
 
-static const char s_keymap[4][4] =
+/* Timer2A: 32-bit periodic, time-out interrupt */
+#define TIMER_CTL_TAEN_MASK            (1u << 0)
+#define TIMER_CFG_32BIT                (0x0u)
+#define TIMER_TAMR_PERIODIC            (0x2u)
+#define TIMER_TATO_MASK                (1u << 0)
+
+#define KEYPAD_ROWS                    (4u)
+#define KEYPAD_COLS                    (4u)
+#define KEYPAD_KEYS                    (KEYPAD_ROWS * KEYPAD_COLS)
+
+/* Row switch to column read; the pull-ups charge a few cm of ribbon in
+ * well under 1 us */
+#define KEYPAD_SETTLE_US               (10u)
+
+#define DEBOUNCE_TICKS                 (KEYPAD_DEBOUNCE_MS / KEYPAD_TICK_MS)
+#define LONG_TICKS                     (KEYPAD_LONG_MS / KEYPAD_TICK_MS)
+#define REPEAT_TICKS                   (KEYPAD_REPEAT_MS / KEYPAD_TICK_MS)
+
+/* Bit row * 4 + col */
+static const char s_keymap[KEYPAD_KEYS] =
 {
-    {'1','2','3','A'},
-    {'4','5','6','B'},
-    {'7','8','9','C'},
-    {'*','0','#','D'}
+    '1','2','3','A',
+    '4','5','6','B',
+    '7','8','9','C',
+    '*','0','#','D'
 };
 
+typedef enum
+{
+    KEY_UP = 0,
+    KEY_PRESSING,     /* down, not yet for DEBOUNCE_TICKS */
+    KEY_DOWN,
+    KEY_RELEASING     /* up, not yet for DEBOUNCE_TICKS */
+} Keypad_KeyState;
+
+/* Timer ISR only */
+static uint8_t  s_key_state[KEYPAD_KEYS];
+static uint8_t  s_key_stable[KEYPAD_KEYS];     /* ticks in PRESSING/RELEASING */
+static uint16_t s_key_held[KEYPAD_KEYS];       /* ticks since PRESS */
+
+/* Single producer (timer ISR), single consumer (APP) */
+static Keypad_EventType s_events[KEYPAD_EVENT_QUEUE_LEN];
+static volatile uint8_t s_ev_head = 0u;       /* next to read */
+static volatile uint8_t s_ev_tail = 0u;       /* next to write */
+static volatile uint16_t s_ev_dropped = 0u;
+
+/* Timer ISR only: debounced keys down, last unambiguous raw scan */
+static uint16_t s_keys_down = 0u;
+static uint16_t s_last_scan = 0u;
+static volatile uint16_t s_ghost_scans = 0u;
+
+/* Open drain: "high" lets the row float up through the column pull-ups */
 static void Keypad_SetAllRowsHigh(void)
 {
     GPIO_PORTD_DATA_R |= ROWS_MASK;
@@ -34,55 +89,240 @@ static void Keypad_DriveRowLow(uint8_t row)
     GPIO_PORTD_DATA_R &= (uint8_t)(~(1u << row));
 }
 
-static Std_ReturnType Keypad_ScanOnce(char *out)
+static void Keypad_OnClockChange(uint32_t sysclk_hz)
 {
-    uint8_t row;
+    TIMER2_TAILR_R = ((sysclk_hz / 1000u) * KEYPAD_TICK_MS) - 1u;
+}
 
-    if (out == (char *)0)
+static void Keypad_StartTick(void)
+{
+    TIMER2_CTL_R |= TIMER_CTL_TAEN_MASK;
+}
+
+static void Keypad_StopTick(void)
+{
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+    TIMER2_ICR_R = TIMER_TATO_MASK;
+}
+
+/* Idle state: every key shorts a low row to its column */
+static void Keypad_Arm(void)
+{
+    GPIO_PORTD_DATA_R &= (uint32_t)(~ROWS_MASK);
+
+    GPIO_PORTE_ICR_R = COLS_MASK;
+    GPIO_PORTE_IM_R |= COLS_MASK;
+
+    /* Pressed before the unmask: there will be no edge for it */
+    if ((GPIO_PORTE_DATA_R & COLS_MASK) != COLS_MASK)
     {
-        return E_NOT_OK;
+        GPIO_PORTE_IM_R &= (uint32_t)(~COLS_MASK);
+        Keypad_StartTick();
     }
+}
 
-    for (row = 0u; row < 4u; row++)
-    {
-        uint8_t cols;
-        uint8_t col_index;
+/* Bit row * 4 + col set for each key down, ~4 x 10 us. Rows are left low
+ * as the idle state wants them. */
+static uint16_t Keypad_ReadMatrix(void)
+{
+    uint16_t down = 0u;
+    uint32_t cols;
+    uint8_t row;
 
+    for (row = 0u; row < KEYPAD_ROWS; row++)
+    {
         Keypad_DriveRowLow(row);
-        Delay_ms(SCAN_SETTLE_MS);
+        Delay_us(KEYPAD_SETTLE_US);
+
+        cols = (~GPIO_PORTE_DATA_R & COLS_MASK) >> COLS_SHIFT;
+        down |= (uint16_t)(cols << (row * KEYPAD_COLS));
+    }
 
-        cols = (uint8_t)(GPIO_PORTE_DATA_R & COLS_MASK);
+    GPIO_PORTD_DATA_R &= (uint32_t)(~ROWS_MASK);
 
-        if (cols != COLS_MASK)
+    return down;
+}
+
+static void Keypad_PushEvent(uint8_t key, Keypad_EventKind kind)
+{
+    uint8_t next = (uint8_t)((s_ev_tail + 1u) % KEYPAD_EVENT_QUEUE_LEN);
+
+    /* Full: keep the older events, they happened first */
+    if (next == s_ev_head)
+    {
+        if (s_ev_dropped < 0xFFFFu)
         {
-            if ((cols & (1u << 1)) == 0u)      { col_index = 0u; }
-            else if ((cols & (1u << 2)) == 0u) { col_index = 1u; }
-            else if ((cols & (1u << 3)) == 0u) { col_index = 2u; }
-            else                                { col_index = 3u; }
+            s_ev_dropped++;
+        }
+        return;
+    }
+
+    s_events[s_ev_tail].key = s_keymap[key];
+    s_events[s_ev_tail].kind = kind;
+    s_events[s_ev_tail].keys = s_keys_down;
+    s_events[s_ev_tail].time_ms = Delay_GetTicksMsFromIsr();
+    s_ev_tail = next;
+}
 
-            /* Wait release */
-            while (((uint8_t)(GPIO_PORTE_DATA_R & COLS_MASK)) != COLS_MASK)
+/* One tick of one key; TRUE while it is anything but settled up */
+static boolean Keypad_StepKey(uint8_t key, boolean raw_down)
+{
+    switch (s_key_state[key])
+    {
+        case KEY_UP:
+            if (raw_down == TRUE)
             {
-                /* busy wait: acceptable for keypad (documented deviation) */
+                s_key_state[key] = KEY_PRESSING;
+                s_key_stable[key] = 1u;
             }
+            break;
 
-            Delay_ms(DEBOUNCE_MS);
+        case KEY_PRESSING:
+            if (raw_down == FALSE)
+            {
+                /* Bounce or noise */
+                s_key_state[key] = KEY_UP;
+                break;
+            }
 
-            *out = s_keymap[row][col_index];
-            return E_OK;
+            s_key_stable[key]++;
+            if (s_key_stable[key] >= DEBOUNCE_TICKS)
+            {
+                s_key_state[key] = KEY_DOWN;
+                s_key_held[key] = 0u;
+                s_keys_down |= (uint16_t)(1u << key);
+                Keypad_PushEvent(key, KEYPAD_EV_PRESS);
+
+                /* More than one bit set */
+                if ((s_keys_down & (uint16_t)(s_keys_down - 1u)) != 0u)
+                {
+                    Keypad_PushEvent(key, KEYPAD_EV_CHORD);
+                }
+            }
+            break;
+
+        case KEY_DOWN:
+            if (raw_down == FALSE)
+            {
+                s_key_state[key] = KEY_RELEASING;
+                s_key_stable[key] = 1u;
+                break;
+            }
+
+            if (s_key_held[key] < 0xFFFFu)
+            {
+                s_key_held[key]++;
+            }
+
+            if (s_key_held[key] == LONG_TICKS)
+            {
+                Keypad_PushEvent(key, KEYPAD_EV_LONG);
+            }
+            else if ((s_key_held[key] > LONG_TICKS) &&
+                     (((s_key_held[key] - LONG_TICKS) % REPEAT_TICKS) == 0u))
+            {
+                Keypad_PushEvent(key, KEYPAD_EV_REPEAT);
+            }
+            else { }
+            break;
+
+        case KEY_RELEASING:
+        default:
+            if (raw_down == TRUE)
+            {
+                /* Bounce: still the same press */
+                s_key_state[key] = KEY_DOWN;
+                break;
+            }
+
+            s_key_stable[key]++;
+            if (s_key_stable[key] >= DEBOUNCE_TICKS)
+            {
+                s_key_state[key] = KEY_UP;
+                s_keys_down &= (uint16_t)(~(1u << key));
+                Keypad_PushEvent(key, KEYPAD_EV_RELEASE);
+            }
+            break;
+    }
+
+    return (s_key_state[key] != KEY_UP) ? TRUE : FALSE;
+}
+
+void GPIOE_Handler(void)
+{
+    /* Quiet until the keys settle; the row walking would edge again */
+    GPIO_PORTE_IM_R &= (uint32_t)(~COLS_MASK);
+    GPIO_PORTE_ICR_R = COLS_MASK;
+
+    Keypad_StartTick();
+}
+
+/* One scan through every key's state machine; TRUE while any key is
+ * not settled up */
+static boolean Keypad_ProcessScan(uint16_t down)
+{
+    boolean active = FALSE;
+    uint8_t key;
+
+    if (Keypad_IsAmbiguous(down) == TRUE)
+    {
+        down = s_last_scan;
+        if (s_ghost_scans < 0xFFFFu)
+        {
+            s_ghost_scans++;
+        }
+    }
+    else
+    {
+        s_last_scan = down;
+    }
+
+    for (key = 0u; key < KEYPAD_KEYS; key++)
+    {
+        if (Keypad_StepKey(key, ((down & (1u << key)) != 0u) ? TRUE : FALSE) == TRUE)
+        {
+            active = TRUE;
         }
     }
 
-    return E_NOT_OK;
+    return active;
+}
+
+void TIMER2A_Handler(void)
+{
+    uint16_t down;
+
+    TIMER2_ICR_R = TIMER_TATO_MASK;
+
+    PROFILE_BEGIN(PROF_ZONE_KEYPAD_SCAN);
+    down = Keypad_ReadMatrix();
+    PROFILE_END(PROF_ZONE_KEYPAD_SCAN);
+
+    if (Keypad_ProcessScan(down) == FALSE)
+    {
+        /* All up: back to sleep until the next column edge */
+        Keypad_StopTick();
+        Keypad_Arm();
+    }
+}
+
+void Keypad_InjectScan(uint16_t down)
+{
+    (void)Keypad_ProcessScan(down);
 }
 
 void Keypad_Init(void)
 {
+    uint8_t key;
+
     SYSCTL_RCGCGPIO_R |= (SYSCTL_RCGCGPIO_PORTD_MASK | SYSCTL_RCGCGPIO_PORTE_MASK);
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_TIMER2_MASK;
     (void)SYSCTL_RCGCGPIO_R;
+    (void)SYSCTL_RCGCTIMER_R;
 
     /* PD0..PD3 output */
     GPIO_PORTD_DIR_R |= ROWS_MASK;
+    GPIO_PORTD_ODR_R |= ROWS_MASK;
     GPIO_PORTD_DEN_R |= ROWS_MASK;
     GPIO_PORTD_AFSEL_R &= ~ROWS_MASK;
     GPIO_PORTD_AMSEL_R &= ~ROWS_MASK;
@@ -94,16 +334,123 @@ void Keypad_Init(void)
     GPIO_PORTE_AFSEL_R &= (uint32_t)(~COLS_MASK);
     GPIO_PORTE_AMSEL_R &= (uint32_t)(~COLS_MASK);
 
-    Keypad_SetAllRowsHigh();
+    /* Falling edge on each column, masked until armed */
+    GPIO_PORTE_IM_R &= (uint32_t)(~COLS_MASK);
+    GPIO_PORTE_IS_R &= (uint32_t)(~COLS_MASK);
+    GPIO_PORTE_IBE_R &= (uint32_t)(~COLS_MASK);
+    GPIO_PORTE_IEV_R &= (uint32_t)(~COLS_MASK);
+
+    /* Timer2A: periodic scan tick, stopped while idle */
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN_MASK;
+    TIMER2_CFG_R = TIMER_CFG_32BIT;
+    TIMER2_TAMR_R = TIMER_TAMR_PERIODIC;
+    Keypad_OnClockChange(Clock_GetSysClkHz());
+    TIMER2_ICR_R = TIMER_TATO_MASK;
+    TIMER2_IMR_R |= TIMER_TATO_MASK;
+    (void)Clock_RegisterListener(Keypad_OnClockChange);
+
+    for (key = 0u; key < KEYPAD_KEYS; key++)
+    {
+        s_key_state[key] = KEY_UP;
+    }
+    s_keys_down = 0u;
+    s_last_scan = 0u;
+    s_ev_head = s_ev_tail;
+
+    NVIC_EN0_R |= (NVIC_EN0_GPIOE_MASK | NVIC_EN0_TIMER2A_MASK);
+    Keypad_Arm();
+}
+
+Std_ReturnType Keypad_GetEvent(Keypad_EventType *ev)
+{
+    uint8_t head = s_ev_head;
+
+    if ((ev == (Keypad_EventType *)0) || (head == s_ev_tail))
+    {
+        return E_NOT_OK;
+    }
+
+    *ev = s_events[head];
+    s_ev_head = (uint8_t)((head + 1u) % KEYPAD_EVENT_QUEUE_LEN);
+
+    return E_OK;
+}
+
+uint16_t Keypad_GetDroppedEvents(void)
+{
+    return s_ev_dropped;
+}
+
+uint16_t Keypad_KeyMask(char key)
+{
+    uint8_t i;
+
+    for (i = 0u; i < KEYPAD_KEYS; i++)
+    {
+        if (s_keymap[i] == key)
+        {
+            return (uint16_t)(1u << i);
+        }
+    }
+
+    return 0u;
+}
+
+/* Six row pairs, an AND and a two-bits test each: cheap next to the
+ * 40 us of row settling in the same tick */
+boolean Keypad_IsAmbiguous(uint16_t down)
+{
+    uint8_t r1;
+    uint8_t r2;
+    uint16_t shared;
+
+    for (r1 = 0u; r1 < (KEYPAD_ROWS - 1u); r1++)
+    {
+        for (r2 = (uint8_t)(r1 + 1u); r2 < KEYPAD_ROWS; r2++)
+        {
+            shared = (uint16_t)((down >> (r1 * KEYPAD_COLS)) & (down >> (r2 * KEYPAD_COLS)) & 0x0Fu);
+
+            if ((shared & (uint16_t)(shared - 1u)) != 0u)
+            {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+uint16_t Keypad_GetGhostScans(void)
+{
+    return s_ghost_scans;
+}
+
+static Std_ReturnType Keypad_NextPress(char *out)
+{
+    Keypad_EventType ev;
+
+    while (Keypad_GetEvent(&ev) == E_OK)
+    {
+        if (ev.kind == KEYPAD_EV_PRESS)
+        {
+            *out = ev.key;
+            return E_OK;
+        }
+    }
+
+    return E_NOT_OK;
 }
 
 char Keypad_GetKey(void)
 {
     char k = '\0';
 
-    while (Keypad_ScanOnce(&k) != E_OK)
+    while (Keypad_NextPress(&k) != E_OK)
     {
-        /* wait */
+#if !defined(DELAY_VIRTUAL_TIME)
+        /* Asleep until a column edge, a scan tick or the SysTick */
+        __WFI();
+#endif
     }
 
     return k;
@@ -120,15 +467,26 @@ Std_ReturnType Keypad_GetKeyTimeout(uint32_t timeout_ms, char *out)
     }
 
     start = Delay_GetTicksMs();
+    Delay_ArmDeadline(start + timeout_ms);
 
-    while ((Delay_GetTicksMs() - start) < timeout_ms)
+    /* Always look at least once: timeout 0 is a non-blocking poll */
+    do
     {
-        if (Keypad_ScanOnce(&k) == E_OK)
+        if (Keypad_NextPress(&k) == E_OK)
         {
             *out = k;
+            Delay_NoteActivity();
             return E_OK;
         }
-    }
+
+        /* Nothing ticks under virtual time: polling moves the clock */
+#if !defined(DELAY_VIRTUAL_TIME)
+        if (timeout_ms != 0u)
+        {
+            __WFI();
+        }
+#endif
+    } while ((Delay_GetTicksMs() - start) < timeout_ms);
 
     return E_NOT_OK;
 }
@@ -4,12 +4,63 @@
 #include <stdint.h>
 #include "../Common/Std_Types.h"
 
-/* Blocking read */
+/* Event timing; the state machine steps every KEYPAD_TICK_MS */
+#define KEYPAD_TICK_MS              (5u)
+#define KEYPAD_DEBOUNCE_MS          (20u)   /* stable this long to count */
+#define KEYPAD_LONG_MS              (800u)  /* held: one LONG event */
+#define KEYPAD_REPEAT_MS            (150u)  /* then a REPEAT every period */
+
+/* One slot stays free to tell full from empty */
+#define KEYPAD_EVENT_QUEUE_LEN      (16u)
+
+typedef enum
+{
+    KEYPAD_EV_PRESS = 0,
+    KEYPAD_EV_RELEASE,
+    KEYPAD_EV_LONG,
+    KEYPAD_EV_REPEAT,
+    KEYPAD_EV_CHORD     /* follows a PRESS made while other keys were down */
+} Keypad_EventKind;
+
+typedef struct
+{
+    char             key;
+    Keypad_EventKind kind;
+    uint16_t         keys;      /* Keypad_KeyMask() of every key down after it */
+    uint32_t         time_ms;   /* Delay_GetTicksMs() when debounced */
+} Keypad_EventType;
+
+/* Blocking read of the next press; sleeps (WFI) between key presses */
 char Keypad_GetKey(void);
 
-/* Timeout read (recommended for MISRA friendliness) */
+/* Next press within timeout_ms (recommended for MISRA friendliness);
+ * 0 = single poll. Other events in the way are dropped. */
 Std_ReturnType Keypad_GetKeyTimeout(uint32_t timeout_ms, char *out);
 
+/* Oldest queued event, E_NOT_OK when there is none. Events are produced
+ * in the timer ISR; if APP falls KEYPAD_EVENT_QUEUE_LEN - 1 behind, new
+ * ones are dropped and counted. */
+Std_ReturnType Keypad_GetEvent(Keypad_EventType *ev);
+uint16_t Keypad_GetDroppedEvents(void);
+
+/* Bit of a key in Keypad_EventType.keys; 0 if it is not on the pad */
+uint16_t Keypad_KeyMask(char key);
+
+/* Without diodes, three keys on the corners of a rectangle pull the
+ * fourth corner down too. A scan where two rows share two or more
+ * columns is ambiguous; the driver ignores it and keeps the last clean
+ * one until the keys change. */
+boolean Keypad_IsAmbiguous(uint16_t down);
+uint16_t Keypad_GetGhostScans(void);
+
+/* Also enables the PE1..PE4 column interrupts and leaves all rows low */
 void Keypad_Init(void);
 
+/* GPIO Port E vector; tests call it to fake a column edge */
+void GPIOE_Handler(void);
+
+/* One scan tick with down as the raw matrix, no GPIO involved. Tests
+ * only, while no real key is down (the scan tick is then stopped). */
+void Keypad_InjectScan(uint16_t down);
+
 #endif /* KEYPAD_H_ */
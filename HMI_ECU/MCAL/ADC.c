@@ -1,6 +1,115 @@
 #include "ADC.h"
 #include "TM4C123GH6PM.h"
 #include "../MCAL/delay.h"
+#include "../MCAL/Clock.h"
+
+#define SYSCTL_RCGCTIMER_TIMER1_MASK   (1u << 1)
+
+#define ADC_SS1_MASK        (1u << 1)
+#define ADC_SS2_MASK        (1u << 2)
+#define ADC_SS3_MASK        (1u << 3)
+#define ADC_EMUX_SS1_MASK   (0x00F0u)
+#define ADC_EMUX_SS2_MASK   (0x0F00u)
+#define ADC_EMUX_SS2_TIMER  (0x0500u)
+#define ADC_EMUX_SS3_MASK   (0xF000u)
+#define ADC_EMUX_SS3_TIMER  (0x5000u)
+#define NVIC_EN0_ADC0SS2_MASK (1u << 16)
+#define NVIC_EN0_ADC0SS3_MASK (1u << 17)
+
+/* Band watch: SS2 converts the pot twice per trigger, step 0 into
+ * comparator 0 (below the band), step 1 into comparator 1 (above it).
+ * Samples go to the comparators only, nothing reaches a FIFO. */
+#define ADC_POT_CHANNEL     (10u)
+#define ADC_SSCTL2_END1     (1u << 5)
+#define ADC_SSOP2_BOTH_DC   ((1u << 0) | (1u << 4))
+#define ADC_SSDC2_DC0_DC1   ((0u << 0) | (1u << 4))
+#define ADC_IM_DCONSS2      (1u << 18)
+#define ADC_ISC_DCINSS2     (1u << 18)
+#define ADC_DC_BOTH         (0x3u)
+
+/* Snapshot: SS1 step 0 pot, step 1 supply, step 2 temperature sensor
+ * (TS2 ignores the mux), end and raw interrupt on step 2 */
+#define ADC_SUPPLY_CHANNEL  (11u)           /* PB5 */
+#define ADC_SUPPLY_PIN      (1u << 5)
+#define ADC_SSMUX1_SNAPSHOT (ADC_POT_CHANNEL | (ADC_SUPPLY_CHANNEL << 4))
+#define ADC_SSCTL1_SNAPSHOT ((1u << 11) | (1u << 10) | (1u << 9))   /* TS2 IE2 END2 */
+#define ADC_SNAPSHOT_STEPS  (3u)
+
+/* Rail mV = counts * 3300 mV * 2 / 4096 */
+#define ADC_VREF_MV         (3300u)
+#define ADC_SUPPLY_DIVIDER  (2u)
+
+/* Datasheet: TEMP = 147.5 - (247.5 * counts / 4096) at VREF 3.3 V */
+#define ADC_TEMP_OFFSET_DC  (1475)
+#define ADC_TEMP_SLOPE_DC   (2475)
+
+/* Comparator: interrupt on every sample in the region (a "once" mode
+ * would miss a knob already outside when the watch is armed) */
+#define ADC_DCCTL_CIE       (1u << 4)
+#define ADC_DCCTL_CIC_LOW   (0x0u << 2)
+#define ADC_DCCTL_CIC_HIGH  (0x3u << 2)
+#define ADC_DCCTL_CIM_ALWAYS (0x0u)
+#define ADC_DCCMP(c)        (((uint32)(c) << 16) | (uint32)(c))
+
+/* Timer1A: 32-bit periodic, its time-out starts a conversion */
+#define TIMER_CTL_TAEN_MASK  (1u << 0)
+#define TIMER_CTL_TAOTE_MASK (1u << 5)
+#define TIMER_CFG_32BIT      (0x0u)
+#define TIMER_TAMR_PERIODIC  (0x2u)
+
+#define ADC_FULL_SCALE      (4096u)
+#define ADC_SAMPLE_MASK     (0x0FFFu)
+
+/* 64 conversions per sample: ~64 us at 1 Msps, noise down 8x */
+#define ADC_SAC_64X         (0x6u)
+
+/* y += (x - y) / 8, with y in 1/16 counts so the division keeps its
+ * fraction */
+#define ADC_IIR_SHIFT       (3u)
+#define ADC_IIR_FRAC_BITS   (4u)
+
+/* How far past a level's edge the filtered value has to go to leave it;
+ * under a sixth of a step for the 26 timeout levels */
+#define ADC_HYST_COUNTS     (24u)
+
+static uint32  s_iir = 0u;              /* Q4 counts */
+static boolean s_iir_valid = FALSE;
+static uint16  s_level = 0u;
+static uint16  s_levels = 0u;           /* 0 = no level yet */
+
+/* Continuous mode: single producer (ISR), single consumer (APP) */
+static volatile boolean s_continuous = FALSE;
+static volatile boolean s_watching = FALSE;
+static uint32           s_rate_hz = 0u;
+static volatile uint16  s_latest = 0u;
+static volatile boolean s_have_latest = FALSE;
+static uint16           s_ring[ADC_RING_LEN];
+static volatile uint8   s_ring_head = 0u;      /* next to read */
+static volatile uint8   s_ring_tail = 0u;      /* next to write */
+static volatile uint16  s_ring_dropped = 0u;
+
+static void ADC_OnClockChange(uint32_t sysclk_hz)
+{
+    if (s_rate_hz != 0u)
+    {
+        TIMER1_TAILR_R = (sysclk_hz / s_rate_hz) - 1u;
+    }
+}
+
+/* y += (x - y) / 8, on an unsigned state: add x/8, take y/8 */
+static void ADC_FilterSample(uint16 raw)
+{
+    if (s_iir_valid == FALSE)
+    {
+        s_iir = (uint32)raw << ADC_IIR_FRAC_BITS;
+        s_iir_valid = TRUE;
+    }
+    else
+    {
+        s_iir = (s_iir - (s_iir >> ADC_IIR_SHIFT)) +
+                (((uint32)raw << ADC_IIR_FRAC_BITS) >> ADC_IIR_SHIFT);
+    }
+}
 
 void ADC_Init(void)
 {
@@ -10,34 +119,337 @@ void ADC_Init(void)
     (void)SYSCTL_RCGCGPIO_R;
     (void)SYSCTL_RCGCADC_R;
 
-    GPIO_PORTB_AFSEL_R |= (1u << 4);
-    GPIO_PORTB_DEN_R   &= ~(1u << 4);
-    GPIO_PORTB_AMSEL_R |= (1u << 4);
+    GPIO_PORTB_AFSEL_R |= ((1u << 4) | ADC_SUPPLY_PIN);
+    GPIO_PORTB_DEN_R   &= ~((1u << 4) | ADC_SUPPLY_PIN);
+    GPIO_PORTB_AMSEL_R |= ((1u << 4) | ADC_SUPPLY_PIN);
 
     ADC0_ACTSS_R &= ~(1u << 3);
+    ADC0_SAC_R    = ADC_SAC_64X;
     ADC0_EMUX_R  &= ~0xF000u;
     ADC0_SSMUX3_R = 10u;
     ADC0_SSCTL3_R = (1u << 1) | (1u << 2);
     ADC0_ACTSS_R |= (1u << 3);
+
+    /* Snapshot sequencer, processor triggered */
+    ADC0_ACTSS_R &= ~ADC_SS1_MASK;
+    ADC0_EMUX_R  &= ~ADC_EMUX_SS1_MASK;
+    ADC0_SSMUX1_R = ADC_SSMUX1_SNAPSHOT;
+    ADC0_SSCTL1_R = ADC_SSCTL1_SNAPSHOT;
+    ADC0_ACTSS_R |= ADC_SS1_MASK;
+
+    /* Timer1A, started by ADC_StartContinuous */
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_TIMER1_MASK;
+    (void)SYSCTL_RCGCTIMER_R;
+    TIMER1_CTL_R &= ~(TIMER_CTL_TAEN_MASK | TIMER_CTL_TAOTE_MASK);
+    TIMER1_CFG_R = TIMER_CFG_32BIT;
+    TIMER1_TAMR_R = TIMER_TAMR_PERIODIC;
+    (void)Clock_RegisterListener(ADC_OnClockChange);
+
+    s_continuous = FALSE;
+    ADC_ResetFilter();
 }
 
+/* A conversion is ~64 us, so spin on RIS against the deadline rather
+ * than sleeping a whole millisecond per look */
 Std_ReturnType ADC_ReadTimeout(uint32 timeout_ms, uint16 *out)
 {
-    uint32 waited = 0u;
+    uint32 start;
 
     if (out == (uint16*)0) { return E_NOT_OK; }
 
+    start = Delay_GetTicksMs();
+    Delay_ArmDeadline(start + timeout_ms);
+
+    if (s_continuous == TRUE)
+    {
+        while (ADC_GetLatest(out) != E_OK)
+        {
+            if ((Delay_GetTicksMs() - start) >= timeout_ms) { return E_NOT_OK; }
+        }
+        return E_OK;
+    }
+
     ADC0_PSSI_R = (1u << 3);
 
     while ((ADC0_RIS_R & (1u << 3)) == 0u)
     {
-        if (waited >= timeout_ms) { return E_NOT_OK; }
-        Delay_ms(1u);
-        waited++;
+        if ((Delay_GetTicksMs() - start) >= timeout_ms) { return E_NOT_OK; }
     }
 
-    *out = (uint16)(ADC0_SSFIFO3_R & 0x0FFFu);
+    *out = (uint16)(ADC0_SSFIFO3_R & ADC_SAMPLE_MASK);
     ADC0_ISC_R = (1u << 3);
 
     return E_OK;
 }
+
+Std_ReturnType ADC_ReadSnapshot(uint32 timeout_ms, ADC_SnapshotType *snap)
+{
+    uint32 start;
+    uint32 raw[ADC_SNAPSHOT_STEPS];
+    uint8 i;
+
+    if (snap == (ADC_SnapshotType*)0) { return E_NOT_OK; }
+
+    start = Delay_GetTicksMs();
+    Delay_ArmDeadline(start + timeout_ms);
+
+    ADC0_ISC_R  = ADC_SS1_MASK;
+    ADC0_PSSI_R = ADC_SS1_MASK;
+
+    while ((ADC0_RIS_R & ADC_SS1_MASK) == 0u)
+    {
+        if ((Delay_GetTicksMs() - start) >= timeout_ms) { return E_NOT_OK; }
+    }
+
+    for (i = 0u; i < ADC_SNAPSHOT_STEPS; i++)
+    {
+        raw[i] = ADC0_SSFIFO1_R & ADC_SAMPLE_MASK;
+    }
+    ADC0_ISC_R = ADC_SS1_MASK;
+
+    snap->pot       = (uint16)raw[0];
+    snap->supply_mv = (uint16)((raw[1] * ADC_VREF_MV * ADC_SUPPLY_DIVIDER) / ADC_FULL_SCALE);
+    snap->temp_dc   = (sint16)(ADC_TEMP_OFFSET_DC - (sint32)((raw[2] * (uint32)ADC_TEMP_SLOPE_DC) / ADC_FULL_SCALE));
+
+    return E_OK;
+}
+
+static uint16 ADC_LevelOf(uint16 value, uint16 levels)
+{
+    return (uint16)(((uint32)value * levels) / ADC_FULL_SCALE);
+}
+
+/* Current level's span, widened by the band on both sides: [lo, hi) */
+static void ADC_LevelBand(uint32 *lo, uint32 *hi)
+{
+    *lo = ((uint32)s_level * ADC_FULL_SCALE) / s_levels;
+    *hi = ((((uint32)s_level + 1u) * ADC_FULL_SCALE) / s_levels) + ADC_HYST_COUNTS;
+
+    *lo = (*lo > ADC_HYST_COUNTS) ? (*lo - ADC_HYST_COUNTS) : 0u;
+}
+
+Std_ReturnType ADC_ReadLevel(uint32 timeout_ms, uint16 levels, uint16 *level)
+{
+    uint16 raw;
+    uint16 value;
+    uint32 lo;
+    uint32 hi;
+
+    if ((level == (uint16*)0) || (levels == 0u)) { return E_NOT_OK; }
+
+    /* Continuous: the ISR has filtered every sample already, this only
+     * waits for the first one */
+    if (ADC_ReadTimeout(timeout_ms, &raw) != E_OK) { return E_NOT_OK; }
+
+    if (s_continuous == FALSE)
+    {
+        ADC_FilterSample(raw);
+    }
+
+    value = (uint16)((s_iir + (1u << (ADC_IIR_FRAC_BITS - 1u))) >> ADC_IIR_FRAC_BITS);
+    if (value > ADC_SAMPLE_MASK) { value = ADC_SAMPLE_MASK; }
+
+    if (levels != s_levels)
+    {
+        s_level  = ADC_LevelOf(value, levels);
+        s_levels = levels;
+    }
+    else
+    {
+        ADC_LevelBand(&lo, &hi);
+
+        if (((uint32)value < lo) || ((uint32)value >= hi))
+        {
+            s_level = ADC_LevelOf(value, levels);
+        }
+    }
+
+    *level = s_level;
+    return E_OK;
+}
+
+void ADC_ResetFilter(void)
+{
+    /* Filter first: the ISR sets the flag only after filtering */
+    s_iir_valid = FALSE;
+    s_have_latest = FALSE;
+    s_levels = 0u;
+}
+
+/* Comparators off, the pot's own sequencer back on the timer */
+static void ADC_EndWatch(void)
+{
+    ADC0_ACTSS_R &= ~ADC_SS2_MASK;
+    ADC0_IM_R    &= ~ADC_IM_DCONSS2;
+    ADC0_DCCTL0_R = 0u;
+    ADC0_DCCTL1_R = 0u;
+    ADC0_DCISC_R  = ADC_DC_BOTH;
+    ADC0_ISC_R    = ADC_ISC_DCINSS2;
+
+    /* The last sample is from before the knob moved: start over from the
+     * next one. Filter first, as in ADC_ResetFilter; the level stays for
+     * its hysteresis. */
+    s_iir_valid = FALSE;
+    s_have_latest = FALSE;
+    ADC0_ACTSS_R |= ADC_SS3_MASK;
+
+    s_watching = FALSE;
+}
+
+Std_ReturnType ADC_WatchLevel(void)
+{
+    uint32 lo;
+    uint32 hi;
+
+    if ((s_continuous == FALSE) || (s_levels == 0u)) { return E_NOT_OK; }
+    if (s_watching == TRUE) { return E_OK; }
+
+    ADC_LevelBand(&lo, &hi);
+
+    /* Same trigger, other sequencer: SS3 and its interrupt go quiet */
+    ADC0_ACTSS_R &= ~(ADC_SS2_MASK | ADC_SS3_MASK);
+
+    ADC0_SSMUX2_R = ADC_POT_CHANNEL | (ADC_POT_CHANNEL << 4);
+    ADC0_SSCTL2_R = ADC_SSCTL2_END1;
+    ADC0_SSOP2_R  = ADC_SSOP2_BOTH_DC;
+    ADC0_SSDC2_R  = ADC_SSDC2_DC0_DC1;
+    ADC0_EMUX_R   = (ADC0_EMUX_R & ~ADC_EMUX_SS2_MASK) | ADC_EMUX_SS2_TIMER;
+
+    ADC0_DCRIC_R  = ADC_DC_BOTH;
+    ADC0_DCCMP0_R = ADC_DCCMP(lo);
+    ADC0_DCCTL0_R = ADC_DCCTL_CIE | ADC_DCCTL_CIC_LOW | ADC_DCCTL_CIM_ALWAYS;
+
+    /* The top level has nothing above it */
+    if (hi < ADC_FULL_SCALE)
+    {
+        ADC0_DCCMP1_R = ADC_DCCMP(hi);
+        ADC0_DCCTL1_R = ADC_DCCTL_CIE | ADC_DCCTL_CIC_HIGH | ADC_DCCTL_CIM_ALWAYS;
+    }
+    else
+    {
+        ADC0_DCCTL1_R = 0u;
+    }
+
+    ADC0_DCISC_R  = ADC_DC_BOTH;
+    ADC0_ISC_R    = ADC_ISC_DCINSS2;
+    ADC0_IM_R    |= ADC_IM_DCONSS2;
+    NVIC_EN0_R   |= NVIC_EN0_ADC0SS2_MASK;
+
+    s_watching = TRUE;
+    ADC0_ACTSS_R |= ADC_SS2_MASK;
+
+    return E_OK;
+}
+
+boolean ADC_IsWatching(void)
+{
+    return s_watching;
+}
+
+/* The knob left the band: sample it again */
+void ADC0SS2_Handler(void)
+{
+    ADC_EndWatch();
+}
+
+Std_ReturnType ADC_StartContinuous(uint32 rate_hz)
+{
+    if (rate_hz == 0u) { return E_NOT_OK; }
+
+    ADC_StopContinuous();
+
+    s_rate_hz = rate_hz;
+    ADC_OnClockChange(Clock_GetSysClkHz());
+
+    s_ring_head = s_ring_tail;
+    ADC_ResetFilter();
+    s_continuous = TRUE;
+
+    ADC0_ACTSS_R &= ~ADC_SS3_MASK;
+    ADC0_EMUX_R   = (ADC0_EMUX_R & ~ADC_EMUX_SS3_MASK) | ADC_EMUX_SS3_TIMER;
+    ADC0_ISC_R    = ADC_SS3_MASK;
+    ADC0_IM_R    |= ADC_SS3_MASK;
+    ADC0_ACTSS_R |= ADC_SS3_MASK;
+    NVIC_EN0_R   |= NVIC_EN0_ADC0SS3_MASK;
+
+    TIMER1_CTL_R |= (TIMER_CTL_TAOTE_MASK | TIMER_CTL_TAEN_MASK);
+
+    return E_OK;
+}
+
+/* Back to software triggers for ADC_ReadTimeout */
+void ADC_StopContinuous(void)
+{
+    TIMER1_CTL_R &= ~(TIMER_CTL_TAEN_MASK | TIMER_CTL_TAOTE_MASK);
+
+    if (s_watching == TRUE)
+    {
+        ADC_EndWatch();
+    }
+
+    ADC0_ACTSS_R &= ~ADC_SS3_MASK;
+    ADC0_IM_R    &= ~ADC_SS3_MASK;
+    ADC0_EMUX_R  &= ~ADC_EMUX_SS3_MASK;
+    ADC0_ISC_R    = ADC_SS3_MASK;
+    ADC0_ACTSS_R |= ADC_SS3_MASK;
+
+    s_continuous = FALSE;
+    s_rate_hz = 0u;
+}
+
+void ADC0SS3_Handler(void)
+{
+    uint16 raw;
+    uint8 next;
+
+    raw = (uint16)(ADC0_SSFIFO3_R & ADC_SAMPLE_MASK);
+    ADC0_ISC_R = ADC_SS3_MASK;
+
+    ADC_FilterSample(raw);
+    s_latest = raw;
+    s_have_latest = TRUE;
+
+    next = (uint8)((s_ring_tail + 1u) % ADC_RING_LEN);
+    if (next == s_ring_head)
+    {
+        if (s_ring_dropped < 0xFFFFu)
+        {
+            s_ring_dropped++;
+        }
+        return;
+    }
+
+    s_ring[s_ring_tail] = raw;
+    s_ring_tail = next;
+}
+
+Std_ReturnType ADC_GetLatest(uint16 *out)
+{
+    if ((out == (uint16*)0) || (s_have_latest == FALSE)) { return E_NOT_OK; }
+
+    *out = s_latest;
+    return E_OK;
+}
+
+uint8 ADC_ReadSamples(uint16 *buf, uint8 max)
+{
+    uint8 n = 0u;
+    uint8 head = s_ring_head;
+
+    if (buf == (uint16*)0) { return 0u; }
+
+    while ((n < max) && (head != s_ring_tail))
+    {
+        buf[n] = s_ring[head];
+        n++;
+        head = (uint8)((head + 1u) % ADC_RING_LEN);
+    }
+
+    s_ring_head = head;
+    return n;
+}
+
+uint16 ADC_GetDroppedSamples(void)
+{
+    return s_ring_dropped;
+}
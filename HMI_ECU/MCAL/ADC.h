@@ -3,7 +3,61 @@
 
 #include "../Common/Std_Types.h"
 
+/* Samples kept for ADC_ReadSamples; one slot stays free */
+#define ADC_RING_LEN            (16u)
+
+/* One conversion batch for health monitoring: the pot, the 5 V rail
+ * through a 1:2 divider on PB5 (AIN11), and the die temperature */
+typedef struct
+{
+    uint16 pot;             /* counts, not filtered */
+    uint16 supply_mv;
+    sint16 temp_dc;         /* 0.1 degC, +-5 degC per the datasheet */
+} ADC_SnapshotType;
+
 void ADC_Init(void);
+
+/* Sequencer 1, software triggered; does not touch the pot's own
+ * sampling or its filter */
+Std_ReturnType ADC_ReadSnapshot(uint32 timeout_ms, ADC_SnapshotType *snap);
+
+/* One conversion of the pot (AIN10), already averaged 64x in hardware.
+ * While sampling continuously: the latest sample, waiting for a first. */
 Std_ReturnType ADC_ReadTimeout(uint32 timeout_ms, uint16 *out);
 
+/* The pot as one of levels equal steps (0 .. levels - 1), through an
+ * IIR low-pass and a hysteresis band, so a still knob reads one level.
+ * *level is only written on E_OK. While sampling continuously the IIR
+ * runs on every sample in the ISR and this does not wait. */
+Std_ReturnType ADC_ReadLevel(uint32 timeout_ms, uint16 levels, uint16 *level);
+
+/* Next ADC_ReadLevel starts from a fresh sample */
+void ADC_ResetFilter(void);
+
+/* Timer1A triggers the pot sequencer rate_hz times a second; samples
+ * arrive by interrupt, so reading them costs no conversion wait */
+Std_ReturnType ADC_StartContinuous(uint32 rate_hz);
+void ADC_StopContinuous(void);
+
+/* Hand the pot to the digital comparators until it leaves the band
+ * ADC_ReadLevel would hold its current level in: no conversion reaches
+ * the CPU meanwhile. Continuous sampling picks up again by itself when
+ * it does, from a fresh sample: ADC_GetLatest is E_NOT_OK until the
+ * first one. Needs continuous mode and one ADC_ReadLevel first. */
+Std_ReturnType ADC_WatchLevel(void);
+boolean ADC_IsWatching(void);
+
+/* Newest sample, E_NOT_OK if none since the start or a reset */
+Std_ReturnType ADC_GetLatest(uint16 *out);
+
+/* Up to max samples, oldest first; returns how many. When the ring is
+ * full new samples are dropped and counted, as ADC_GetLatest still sees
+ * them. */
+uint8 ADC_ReadSamples(uint16 *buf, uint8 max);
+uint16 ADC_GetDroppedSamples(void);
+
+/* ADC0 sequencer vectors: 3 delivers samples, 2 the comparator wake */
+void ADC0SS2_Handler(void);
+void ADC0SS3_Handler(void);
+
 #endif
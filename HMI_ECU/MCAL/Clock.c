@@ -0,0 +1,148 @@
+#include <stdint.h>
+#include "TM4C123GH6PM.h"
+#include "Clock.h"
+
+/* 16 MHz crystal on MOSC, PLL runs at 400 MHz (DIV400) */
+#define CLOCK_PLL_HZ                (400000000u)
+#define CLOCK_SYSDIV_MIN            (5u)    /* 80 MHz ceiling */
+#define CLOCK_SYSDIV_MAX            (128u)  /* 7-bit SYSDIV2:SYSDIV2LSB */
+
+/* RCC */
+#define SYSCTL_RCC_MOSCDIS_MASK     (1u << 0)
+#define SYSCTL_RCC_XTAL_MASK        (0x1Fu << 6)
+#define SYSCTL_RCC_XTAL_16MHZ       (0x15u << 6)
+
+/* RCC2 */
+#define SYSCTL_RCC2_USERCC2_MASK    (1u << 31)
+#define SYSCTL_RCC2_DIV400_MASK     (1u << 30)
+#define SYSCTL_RCC2_SYSDIV_SHIFT    (22u)   /* SYSDIV2 + SYSDIV2LSB */
+#define SYSCTL_RCC2_SYSDIV_MASK     (0x7Fu << 22)
+#define SYSCTL_RCC2_PWRDN2_MASK     (1u << 13)
+#define SYSCTL_RCC2_BYPASS2_MASK    (1u << 11)
+#define SYSCTL_RCC2_OSCSRC2_MASK    (0x7u << 4)
+#define SYSCTL_RCC2_OSCSRC2_MOSC    (0x0u << 4)
+
+/* RIS, MISC (write 1 to clear); the lock flag is sticky */
+#define SYSCTL_RIS_PLLLRIS_MASK     (1u << 6)
+#define SYSCTL_MISC_PLLLMIS_MASK    (1u << 6)
+
+/* Lock normally takes well under 1 ms; this is a loop bound, not a time */
+#define CLOCK_PLL_LOCK_SPINS        (100000u)
+
+static uint32_t s_sysclk_hz = CLOCK_RESET_HZ;
+
+static Clock_ListenerType s_listeners[CLOCK_MAX_LISTENERS];
+static uint8_t s_listener_count = 0u;
+
+static void Clock_NotifyListeners(void)
+{
+    uint8_t i;
+
+    for (i = 0u; i < s_listener_count; i++)
+    {
+        s_listeners[i](s_sysclk_hz);
+    }
+}
+
+static void Clock_SelectCrystalBypass(void)
+{
+    /* Crystal must be running before anything switches over to it */
+    SYSCTL_RCC_R = (SYSCTL_RCC_R & ~(SYSCTL_RCC_XTAL_MASK | SYSCTL_RCC_MOSCDIS_MASK))
+                 | SYSCTL_RCC_XTAL_16MHZ;
+
+    SYSCTL_RCC2_R |= (SYSCTL_RCC2_USERCC2_MASK | SYSCTL_RCC2_BYPASS2_MASK);
+    SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCTL_RCC2_OSCSRC2_MASK) | SYSCTL_RCC2_OSCSRC2_MOSC;
+}
+
+Std_ReturnType Clock_Init(uint32_t sysclk_hz)
+{
+    uint32_t sysdiv;
+    uint32_t spins = 0u;
+
+    if (sysclk_hz == 0u)
+    {
+        return E_NOT_OK;
+    }
+
+    if (sysclk_hz == CLOCK_16MHZ)
+    {
+        /* Run from the crystal directly and power the PLL down */
+        Clock_SelectCrystalBypass();
+        SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2_MASK;
+
+        s_sysclk_hz = sysclk_hz;
+        Clock_NotifyListeners();
+        return E_OK;
+    }
+
+    sysdiv = CLOCK_PLL_HZ / sysclk_hz;
+
+    if (((CLOCK_PLL_HZ % sysclk_hz) != 0u) ||
+        (sysdiv < CLOCK_SYSDIV_MIN) || (sysdiv > CLOCK_SYSDIV_MAX))
+    {
+        return E_NOT_OK;
+    }
+
+    /* Bypass while the PLL is reprogrammed */
+    Clock_SelectCrystalBypass();
+
+    /* Drop a lock left over from before; only the coming relock counts */
+    SYSCTL_MISC_R = SYSCTL_MISC_PLLLMIS_MASK;
+
+    SYSCTL_RCC2_R &= ~SYSCTL_RCC2_PWRDN2_MASK;
+    SYSCTL_RCC2_R |= SYSCTL_RCC2_DIV400_MASK;
+    SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCTL_RCC2_SYSDIV_MASK)
+                  | ((sysdiv - 1u) << SYSCTL_RCC2_SYSDIV_SHIFT);
+
+    while ((SYSCTL_RIS_R & SYSCTL_RIS_PLLLRIS_MASK) == 0u)
+    {
+        spins++;
+        if (spins >= CLOCK_PLL_LOCK_SPINS)
+        {
+            /* Stay on the crystal: SYSCLK is 16 MHz now */
+            SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2_MASK;
+            s_sysclk_hz = CLOCK_16MHZ;
+            Clock_NotifyListeners();
+            return E_NOT_OK;
+        }
+    }
+
+    SYSCTL_RCC2_R &= ~SYSCTL_RCC2_BYPASS2_MASK;
+
+    s_sysclk_hz = sysclk_hz;
+    Clock_NotifyListeners();
+    return E_OK;
+}
+
+uint32_t Clock_GetSysClkHz(void)
+{
+    return s_sysclk_hz;
+}
+
+Std_ReturnType Clock_RegisterListener(Clock_ListenerType listener)
+{
+    uint8_t i;
+
+    if (listener == (Clock_ListenerType)0)
+    {
+        return E_NOT_OK;
+    }
+
+    /* Drivers register from their Init, which may run more than once */
+    for (i = 0u; i < s_listener_count; i++)
+    {
+        if (s_listeners[i] == listener)
+        {
+            return E_OK;
+        }
+    }
+
+    if (s_listener_count >= CLOCK_MAX_LISTENERS)
+    {
+        return E_NOT_OK;
+    }
+
+    s_listeners[s_listener_count] = listener;
+    s_listener_count++;
+    return E_OK;
+}
@@ -1,27 +1,149 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
 #include "delay.h"
+#include "Clock.h"
 
-/* SysTick runs from system clock. At 16 MHz: 1 ms = 16000 cycles. */
-#define SYSCLK_HZ           (16000000u)
-#define SYSTICK_1MS_RELOAD  ((SYSCLK_HZ / 1000u) - 1u)
+/* SysTick runs from system clock: 1 ms = SYSCLK / 1000 cycles. */
+#define SYSTICK_1MS_RELOAD(hz)  (((hz) / 1000u) - 1u)
 
 static volatile uint32_t g_msTicks = 0u;
 
+#if defined(DELAY_VIRTUAL_TIME)
+/* Host build: nothing ticks on its own. Delay_ms() jumps straight to its
+ * end, and a caller that keeps polling the clock with nothing else going
+ * on is jumped to the earliest deadline armed by a timed wait. */
+#define DELAY_VT_MAX_DEADLINES  (8u)
+#define DELAY_VT_IDLE_POLLS     (16u)
+#define DELAY_VT_HORIZON_MS     (0x80000000u)   /* beyond this it is in the past */
+
+static uint32_t s_vt_deadlines[DELAY_VT_MAX_DEADLINES];
+static uint8_t  s_vt_count = 0u;
+static uint32_t s_vt_idle_polls = 0u;
+
+static boolean Delay_VtIsPending(uint32_t deadline_ms)
+{
+    uint32_t ahead = deadline_ms - g_msTicks;
+
+    return ((ahead != 0u) && (ahead < DELAY_VT_HORIZON_MS)) ? TRUE : FALSE;
+}
+
+static void Delay_VtAdvanceTo(uint32_t now_ms)
+{
+    uint8_t i = 0u;
+
+    g_msTicks = now_ms;
+    s_vt_idle_polls = 0u;
+
+    /* Drop everything that has come due */
+    while (i < s_vt_count)
+    {
+        if (Delay_VtIsPending(s_vt_deadlines[i]) == FALSE)
+        {
+            s_vt_count--;
+            s_vt_deadlines[i] = s_vt_deadlines[s_vt_count];
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+static void Delay_VtJumpToNextDeadline(void)
+{
+    uint32_t nearest = DELAY_VT_HORIZON_MS;
+    uint8_t i;
+
+    for (i = 0u; i < s_vt_count; i++)
+    {
+        uint32_t ahead = s_vt_deadlines[i] - g_msTicks;
+
+        if ((ahead != 0u) && (ahead < nearest))
+        {
+            nearest = ahead;
+        }
+    }
+
+    /* Nobody armed anything: creep forward so plain polls still expire */
+    if (nearest == DELAY_VT_HORIZON_MS)
+    {
+        nearest = 1u;
+    }
+
+    Delay_VtAdvanceTo(g_msTicks + nearest);
+}
+
+void Delay_ArmDeadline(uint32_t deadline_ms)
+{
+    uint8_t i;
+    uint8_t latest = 0u;
+
+    if (Delay_VtIsPending(deadline_ms) == FALSE)
+    {
+        return;
+    }
+
+    for (i = 0u; i < s_vt_count; i++)
+    {
+        if (s_vt_deadlines[i] == deadline_ms)
+        {
+            return;
+        }
+        if ((s_vt_deadlines[i] - g_msTicks) > (s_vt_deadlines[latest] - g_msTicks))
+        {
+            latest = i;
+        }
+    }
+
+    if (s_vt_count < DELAY_VT_MAX_DEADLINES)
+    {
+        s_vt_deadlines[s_vt_count] = deadline_ms;
+        s_vt_count++;
+    }
+    else if ((deadline_ms - g_msTicks) < (s_vt_deadlines[latest] - g_msTicks))
+    {
+        /* Full: the furthest one is re-armed by its poller if still needed */
+        s_vt_deadlines[latest] = deadline_ms;
+    }
+    else
+    {
+        /* Keep the nearer ones */
+    }
+}
+
+void Delay_NoteActivity(void)
+{
+    s_vt_idle_polls = 0u;
+}
+#endif /* DELAY_VIRTUAL_TIME */
+
+#if !defined(DELAY_VIRTUAL_TIME)
+static void Delay_OnClockChange(uint32_t sysclk_hz)
+{
+    /* Keep counting; the new period starts at the next wrap */
+    NVIC_ST_RELOAD_R = SYSTICK_1MS_RELOAD(sysclk_hz);
+}
+#endif
+
 void SysTick_Handler(void)
 {
     g_msTicks++;
 }
 
-void Delay_Init_16MHz(void)
+void Delay_Init(void)
 {
     g_msTicks = 0u;
 
+#if defined(DELAY_VIRTUAL_TIME)
+    s_vt_count = 0u;
+    s_vt_idle_polls = 0u;
+#else
+
     /* Disable SysTick during setup */
     NVIC_ST_CTRL_R = 0u;
 
     /* Reload for 1ms tick */
-    NVIC_ST_RELOAD_R = SYSTICK_1MS_RELOAD;
+    NVIC_ST_RELOAD_R = SYSTICK_1MS_RELOAD(Clock_GetSysClkHz());
 
     /* Clear current value */
     NVIC_ST_CURRENT_R = 0u;
@@ -32,19 +154,61 @@ void Delay_Init_16MHz(void)
      * ENABLE=1
      */
     NVIC_ST_CTRL_R = (1u << 2) | (1u << 1) | (1u << 0);
+
+    (void)Clock_RegisterListener(Delay_OnClockChange);
+#endif
 }
 
 uint32_t Delay_GetTicksMs(void)
+{
+#if defined(DELAY_VIRTUAL_TIME)
+    s_vt_idle_polls++;
+    if (s_vt_idle_polls > DELAY_VT_IDLE_POLLS)
+    {
+        Delay_VtJumpToNextDeadline();
+    }
+#endif
+    return g_msTicks;
+}
+
+uint32_t Delay_GetTicksMsFromIsr(void)
 {
     return g_msTicks;
 }
 
 void Delay_ms(uint32_t ms)
 {
+#if defined(DELAY_VIRTUAL_TIME)
+    Delay_VtAdvanceTo(g_msTicks + ms);
+#else
     uint32_t start = g_msTicks;
 
     while ((g_msTicks - start) < ms)
     {
         /* wait */
     }
+#endif
+}
+
+void Delay_us(uint32_t us)
+{
+#if defined(DELAY_VIRTUAL_TIME)
+    (void)us;
+#else
+    /* SysTick counts down from RELOAD and wraps every millisecond */
+    const uint32_t period = NVIC_ST_RELOAD_R + 1u;
+    uint32_t remaining = us * (Clock_GetSysClkHz() / 1000000u);
+    uint32_t last = NVIC_ST_CURRENT_R;
+    uint32_t now;
+    uint32_t elapsed;
+
+    while (remaining > 0u)
+    {
+        now = NVIC_ST_CURRENT_R;
+        elapsed = (last >= now) ? (last - now) : ((last + period) - now);
+        last = now;
+
+        remaining = (elapsed >= remaining) ? 0u : (remaining - elapsed);
+    }
+#endif
 }
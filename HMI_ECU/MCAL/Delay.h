@@ -3,8 +3,30 @@
 
 #include <stdint.h>
 
-void Delay_Init_16MHz(void);
+/* DELAY_VIRTUAL_TIME is for a host harness that supplies its own register
+ * and intrinsic stubs; this tree has no such build. The millisecond clock
+ * then only moves when someone waits, and __WFI is skipped. */
+
+void Delay_Init(void);
 void Delay_ms(uint32_t ms);
+
+/* Busy-waits on the SysTick count, for sub-millisecond bus timing. Valid
+ * up to ~50 s at 80 MHz; virtual time returns at once. */
+void Delay_us(uint32_t us);
 uint32_t Delay_GetTicksMs(void);
 
+/* Same clock for ISRs: under virtual time a Delay_GetTicksMs() call is
+ * counted as an idle poll and may move the clock */
+uint32_t Delay_GetTicksMsFromIsr(void);
+
+#if defined(DELAY_VIRTUAL_TIME)
+/* Timed waits announce when they give up, so a blocked poll can jump there */
+void Delay_ArmDeadline(uint32_t deadline_ms);
+/* Drivers call this when a wait is satisfied, to hold the clock still */
+void Delay_NoteActivity(void);
+#else
+#define Delay_ArmDeadline(deadline_ms)  ((void)(deadline_ms))
+#define Delay_NoteActivity()            ((void)0)
+#endif
+
 #endif /* DELAY_H_ */
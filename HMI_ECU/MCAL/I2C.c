@@ -2,6 +2,8 @@
 #include "TM4C123GH6PM.h"
 #include "I2C.h"
 #include "delay.h"
+#include "Clock.h"
+#include "Profile.h"
 
 /* I2C0: PB2=SCL, PB3=SDA */
 #define SYSCTL_RCGCI2C_I2C0_MASK        (1u << 0)
@@ -15,30 +17,484 @@
 #define I2C_MCS_BUSY_MASK               (1u << 0)
 #define I2C_MCS_ERROR_MASK              (1u << 1)
 #define I2C_MCS_ARBLST_MASK             (1u << 4)
+#define I2C_MCS_BUSBSY_MASK             (1u << 6)
+
+/* Master Configuration */
+#define I2C_MCR_MFE_MASK                (0x10u)
+
+/* MCS write commands */
+#define I2C_MCS_RUN                     (1u << 0)
+#define I2C_MCS_START                   (1u << 1)
+#define I2C_MCS_STOP                    (1u << 2)
+#define I2C_MCS_ACK                     (1u << 3)
+
+/* Master interrupt: MIMR/MICR bit 0 */
+#define I2C_MIMR_IM_MASK                (1u << 0)
+#define I2C_MICR_IC_MASK                (1u << 0)
+
+/* I2C0 is IRQ 8: EN0 bit 8, PRI2 bits [7:5] */
+#define NVIC_EN0_I2C0_MASK              (1u << 8)
+
+/* SCL period = 2 * (1 + TPR) * (SCL_LP + SCL_HP) clocks, with LP + HP = 10 */
+#define I2C_SCL_CLOCKS_PER_TPR          (20u)
+
+/* A full queue of LCD flushes is ~25 ms at 100 kHz */
+#define I2C_INIT_DRAIN_MS               (50u)
+
+/* Blocking calls: retries after the first attempt, backoff 1, 2 ms... */
+#define I2C_RETRIES                     (2u)
+#define I2C_BACKOFF_MAX_MS              (4u)
+
+/* Bus clear: a slave stuck mid-byte releases SDA within 9 clocks */
+#define I2C_RECOVER_PULSES              (9u)
+#define I2C_RECOVER_HALF_PERIOD_HZ      (200000u)   /* 5 us half period */
+#define I2C_RECOVER_CYCLES_PER_SPIN     (4u)
+
+typedef enum
+{
+    I2C_FAIL_NONE = 0u,
+    I2C_FAIL_ERROR,         /* address/data NACK or bus error */
+    I2C_FAIL_TIMEOUT,
+    I2C_FAIL_ARBLST
+} I2C_FailKind;
+
+static uint32_t s_scl_hz = I2C0_SPEED_STANDARD_HZ;
+static uint8_t s_fail_streak = 0u;
+
+/* Why the last blocking wait failed; decides whether a retry clears the bus */
+static I2C_FailKind s_last_fail = I2C_FAIL_NONE;
+
+/* Slots are claimed by address on first failure and kept until cleared */
+static I2C0_DeviceStatsType s_stats[I2C0_STATS_SLOTS];
+static uint8_t s_stats_used = 0u;
+
+/* Ring of pending transactions; s_q_head is the one on the bus. The ISR
+ * only advances the head and the caller only the tail, so Submit needs
+ * no lock: whoever sees an idle engine with work queued starts it. */
+static I2C0_XferType s_queue[I2C0_QUEUE_LEN];
+static volatile uint8_t s_q_head = 0u;
+static volatile uint8_t s_q_tail = 0u;
+static volatile boolean s_active = FALSE;
+
+/* Position in the active transaction; s_stopping after a NACK mid-burst */
+static uint8_t s_xfer_pos = 0u;
+static boolean s_stopping = FALSE;
+
+static uint32_t I2C0_ComputeTpr(uint32_t sysclk_hz, uint32_t scl_hz)
+{
+    uint32_t tpr = sysclk_hz / (I2C_SCL_CLOCKS_PER_TPR * scl_hz);
+
+    /* Round the divider up so SCL never exceeds the requested rate */
+    if ((sysclk_hz % (I2C_SCL_CLOCKS_PER_TPR * scl_hz)) == 0u)
+    {
+        tpr--;
+    }
+
+    if (tpr > 0x7Fu)
+    {
+        tpr = 0x7Fu;
+    }
+
+    return tpr;
+}
+
+static void I2C0_OnClockChange(uint32_t sysclk_hz)
+{
+    I2C0_MTPR_R = I2C0_ComputeTpr(sysclk_hz, s_scl_hz);
+}
+
+/* Called with the controller idle after every transaction. The PCF8574
+ * is only specified for 100 kHz, so a fast bus that keeps failing drops
+ * a grade rather than garbling the panel. */
+static void I2C0_NoteResult(Std_ReturnType ret)
+{
+    if (ret == E_OK)
+    {
+        s_fail_streak = 0u;
+        return;
+    }
+
+    if (s_scl_hz == I2C0_SPEED_STANDARD_HZ)
+    {
+        return;
+    }
+
+    s_fail_streak++;
+    if (s_fail_streak >= I2C0_STEPDOWN_FAILURES)
+    {
+        s_fail_streak = 0u;
+        s_scl_hz = (s_scl_hz > I2C0_SPEED_FAST_HZ) ? I2C0_SPEED_FAST_HZ : I2C0_SPEED_STANDARD_HZ;
+        I2C0_MTPR_R = I2C0_ComputeTpr(Clock_GetSysClkHz(), s_scl_hz);
+    }
+}
+
+static I2C_FailKind I2C0_StatusToFail(uint32_t status)
+{
+    if ((status & I2C_MCS_ARBLST_MASK) != 0u)
+    {
+        return I2C_FAIL_ARBLST;
+    }
+
+    if ((status & I2C_MCS_ERROR_MASK) != 0u)
+    {
+        return I2C_FAIL_ERROR;
+    }
+
+    return I2C_FAIL_NONE;
+}
+
+static void I2C0_CountFailure(uint8_t addr, I2C_FailKind kind)
+{
+    I2C0_DeviceStatsType *slot = (I2C0_DeviceStatsType *)0;
+    uint8_t i;
+
+    for (i = 0u; i < s_stats_used; i++)
+    {
+        if (s_stats[i].addr == addr)
+        {
+            slot = &s_stats[i];
+        }
+    }
+
+    if (slot == (I2C0_DeviceStatsType *)0)
+    {
+        if (s_stats_used >= I2C0_STATS_SLOTS)
+        {
+            return;
+        }
+
+        slot = &s_stats[s_stats_used];
+        s_stats_used++;
+        slot->addr = addr;
+        slot->errors = 0u;
+        slot->timeouts = 0u;
+        slot->arb_lost = 0u;
+    }
+
+    /* Saturate rather than wrap back to "healthy" */
+    if ((kind == I2C_FAIL_TIMEOUT) && (slot->timeouts < 0xFFFFu))
+    {
+        slot->timeouts++;
+    }
+    else if ((kind == I2C_FAIL_ARBLST) && (slot->arb_lost < 0xFFFFu))
+    {
+        slot->arb_lost++;
+    }
+    else if ((kind == I2C_FAIL_ERROR) && (slot->errors < 0xFFFFu))
+    {
+        slot->errors++;
+    }
+    else
+    {
+        /* Saturated */
+    }
+}
 
 static Std_ReturnType I2C0_WaitDone(uint32_t timeout_ms)
 {
     uint32_t start = Delay_GetTicksMs();
 
+    Delay_ArmDeadline(start + timeout_ms);
+
     while ((I2C0_MCS_R & I2C_MCS_BUSY_MASK) != 0u)
     {
         if ((Delay_GetTicksMs() - start) >= timeout_ms)
         {
+            s_last_fail = I2C_FAIL_TIMEOUT;
             return E_NOT_OK;
         }
     }
 
     /* Check error bits */
-    if ((I2C0_MCS_R & (I2C_MCS_ERROR_MASK | I2C_MCS_ARBLST_MASK)) != 0u)
+    s_last_fail = I2C0_StatusToFail(I2C0_MCS_R);
+
+    return (s_last_fail == I2C_FAIL_NONE) ? E_OK : E_NOT_OK;
+}
+
+static void I2C0_RecoverSpin(uint32_t spins)
+{
+    volatile uint32_t n = spins;
+
+    while (n > 0u)
+    {
+        n--;
+    }
+}
+
+Std_ReturnType I2C0_BusRecover(void)
+{
+    uint32_t half = Clock_GetSysClkHz() / (I2C_RECOVER_HALF_PERIOD_HZ * I2C_RECOVER_CYCLES_PER_SPIN);
+    uint8_t i;
+    Std_ReturnType ret;
+
+    /* Take both pins from the controller: SCL driven open-drain, SDA read */
+    GPIO_PORTB_DATA_R |= GPIO_PB23_MASK;
+    GPIO_PORTB_ODR_R  |= GPIO_PB23_MASK;
+    GPIO_PORTB_DIR_R   = (GPIO_PORTB_DIR_R | GPIO_PB2_MASK) & ~GPIO_PB3_MASK;
+    GPIO_PORTB_AFSEL_R &= ~GPIO_PB23_MASK;
+    I2C0_RecoverSpin(half);
+
+    /* Clock out whatever byte the slave thinks it is still sending */
+    for (i = 0u; (i < I2C_RECOVER_PULSES) && ((GPIO_PORTB_DATA_R & GPIO_PB3_MASK) == 0u); i++)
+    {
+        GPIO_PORTB_DATA_R &= ~GPIO_PB2_MASK;
+        I2C0_RecoverSpin(half);
+        GPIO_PORTB_DATA_R |= GPIO_PB2_MASK;
+        I2C0_RecoverSpin(half);
+    }
+
+    ret = ((GPIO_PORTB_DATA_R & GPIO_PB3_MASK) != 0u) ? E_OK : E_NOT_OK;
+
+    /* STOP: SDA low while SCL is low, then SCL high, then SDA high */
+    GPIO_PORTB_DATA_R &= ~GPIO_PB2_MASK;
+    GPIO_PORTB_DATA_R &= ~GPIO_PB3_MASK;
+    GPIO_PORTB_DIR_R  |= GPIO_PB3_MASK;
+    I2C0_RecoverSpin(half);
+    GPIO_PORTB_DATA_R |= GPIO_PB2_MASK;
+    I2C0_RecoverSpin(half);
+    GPIO_PORTB_DATA_R |= GPIO_PB3_MASK;
+    I2C0_RecoverSpin(half);
+
+    /* Hand back to I2C0 as I2C0_Init left them; restart the master */
+    GPIO_PORTB_DIR_R   &= ~GPIO_PB23_MASK;
+    GPIO_PORTB_ODR_R   &= ~GPIO_PB2_MASK;
+    GPIO_PORTB_AFSEL_R |= GPIO_PB23_MASK;
+    I2C0_MCR_R = 0u;
+    I2C0_MCR_R = I2C_MCR_MFE_MASK;
+    I2C0_MTPR_R = I2C0_ComputeTpr(Clock_GetSysClkHz(), s_scl_hz);
+
+    if ((I2C0_MCS_R & I2C_MCS_BUSBSY_MASK) != 0u)
+    {
+        ret = E_NOT_OK;
+    }
+
+    return ret;
+}
+
+/* Before retry n (1-based): clear a hung or contested bus, then back off
+ * 1, 2, 4... ms, capped so a dead device costs a bounded time */
+static void I2C0_PrepareRetry(uint8_t attempt)
+{
+    uint32_t backoff_ms = (uint32_t)1u << (attempt - 1u);
+
+    if ((s_last_fail == I2C_FAIL_TIMEOUT) || (s_last_fail == I2C_FAIL_ARBLST))
+    {
+        (void)I2C0_BusRecover();
+    }
+
+    if (backoff_ms > I2C_BACKOFF_MAX_MS)
+    {
+        backoff_ms = I2C_BACKOFF_MAX_MS;
+    }
+
+    Delay_ms(backoff_ms);
+}
+
+static uint8_t I2C0_QueueNext(uint8_t index)
+{
+    return (uint8_t)((index + 1u) % I2C0_QUEUE_LEN);
+}
+
+/* Put the next byte on the bus. Reads ACK every byte but the last. */
+static void I2C0_IssueByte(const I2C0_XferType *xfer)
+{
+    uint32_t mcs = I2C_MCS_RUN;
+
+    if (s_xfer_pos == 0u)
+    {
+        mcs |= I2C_MCS_START;
+    }
+
+    if (s_xfer_pos == (uint8_t)(xfer->len - 1u))
+    {
+        mcs |= I2C_MCS_STOP;
+    }
+    else if (xfer->read == TRUE)
+    {
+        mcs |= I2C_MCS_ACK;
+    }
+    else
+    {
+        /* Write, more to come */
+    }
+
+    if (xfer->read == FALSE)
+    {
+        I2C0_MDR_R = (uint32_t)xfer->buf[s_xfer_pos];
+    }
+
+    I2C0_MCS_R = mcs;
+}
+
+static void I2C0_StartHead(void)
+{
+    const I2C0_XferType *xfer = &s_queue[s_q_head];
+
+    s_active = TRUE;
+    s_xfer_pos = 0u;
+    s_stopping = FALSE;
+
+    I2C0_MSA_R = ((uint32_t)xfer->addr << 1) | ((xfer->read == TRUE) ? 1u : 0u);
+    I2C0_MIMR_R = I2C_MIMR_IM_MASK;
+    I2C0_IssueByte(xfer);
+}
+
+static void I2C0_FinishHead(Std_ReturnType result)
+{
+    I2C0_CallbackType done = s_queue[s_q_head].done;
+
+    I2C0_NoteResult(result);
+    s_q_head = I2C0_QueueNext(s_q_head);
+
+    if (s_q_head != s_q_tail)
+    {
+        I2C0_StartHead();
+    }
+    else
+    {
+        I2C0_MIMR_R = 0u;
+        s_active = FALSE;
+    }
+
+    /* After the next transfer is on the bus, so a callback may submit */
+    if (done != (I2C0_CallbackType)0)
+    {
+        done(result);
+    }
+}
+
+void I2C0_Handler(void)
+{
+    const I2C0_XferType *xfer = &s_queue[s_q_head];
+    uint32_t status;
+
+    I2C0_MICR_R = I2C_MICR_IC_MASK;
+
+    if (s_active == FALSE)
+    {
+        return;
+    }
+
+    status = I2C0_MCS_R;
+
+    if (s_stopping == TRUE)
+    {
+        I2C0_FinishHead(E_NOT_OK);
+        return;
+    }
+
+    if ((status & (I2C_MCS_ERROR_MASK | I2C_MCS_ARBLST_MASK)) != 0u)
+    {
+        I2C0_CountFailure(xfer->addr, I2C0_StatusToFail(status));
+
+        /* Same rule as the blocking burst: release the bus after a NACK
+         * unless STOP already went out or arbitration was lost */
+        if (((status & I2C_MCS_ARBLST_MASK) == 0u) &&
+            (s_xfer_pos < (uint8_t)(xfer->len - 1u)))
+        {
+            s_stopping = TRUE;
+            I2C0_MCS_R = I2C_MCS_STOP;
+            return;
+        }
+
+        I2C0_FinishHead(E_NOT_OK);
+        return;
+    }
+
+    if (xfer->read == TRUE)
+    {
+        xfer->buf[s_xfer_pos] = (uint8_t)(I2C0_MDR_R & 0xFFu);
+    }
+
+    s_xfer_pos++;
+
+    if (s_xfer_pos < xfer->len)
+    {
+        I2C0_IssueByte(xfer);
+    }
+    else
+    {
+        I2C0_FinishHead(E_OK);
+    }
+}
+
+Std_ReturnType I2C0_Submit(const I2C0_XferType *xfer)
+{
+    uint8_t next;
+
+    if ((xfer == (const I2C0_XferType *)0) || (xfer->buf == (uint8_t *)0) ||
+        (xfer->len == 0u))
+    {
+        return E_NOT_OK;
+    }
+
+    next = I2C0_QueueNext(s_q_tail);
+    if (next == s_q_head)
     {
         return E_NOT_OK;
     }
 
+    s_queue[s_q_tail] = *xfer;
+    s_q_tail = next;
+
+    if (s_active == FALSE)
+    {
+        I2C0_StartHead();
+    }
+
+    return E_OK;
+}
+
+boolean I2C0_IsIdle(void)
+{
+    return (s_active == FALSE) ? TRUE : FALSE;
+}
+
+Std_ReturnType I2C0_WaitIdle(uint32_t timeout_ms)
+{
+    uint32_t start = Delay_GetTicksMs();
+    I2C0_CallbackType done;
+
+    Delay_ArmDeadline(start + timeout_ms);
+
+    while (s_active == TRUE)
+    {
+        if ((Delay_GetTicksMs() - start) >= timeout_ms)
+        {
+            /* Interrupt off first, so the ISR cannot race the drop */
+            I2C0_MIMR_R = 0u;
+            s_active = FALSE;
+            I2C0_CountFailure(s_queue[s_q_head].addr, I2C_FAIL_TIMEOUT);
+            (void)I2C0_BusRecover();
+
+            while (s_q_head != s_q_tail)
+            {
+                done = s_queue[s_q_head].done;
+                s_q_head = I2C0_QueueNext(s_q_head);
+                if (done != (I2C0_CallbackType)0)
+                {
+                    done(E_NOT_OK);
+                }
+            }
+
+            return E_NOT_OK;
+        }
+    }
+
     return E_OK;
 }
 
-void I2C0_Init_100k_16MHz(void)
+Std_ReturnType I2C0_Init(uint32_t scl_hz)
 {
+    if ((scl_hz != I2C0_SPEED_STANDARD_HZ) && (scl_hz != I2C0_SPEED_FAST_HZ) &&
+        (scl_hz != I2C0_SPEED_FAST_PLUS_HZ))
+    {
+        return E_NOT_OK;
+    }
+
+    /* Re-init (LCD recovery) must not strand queued callbacks */
+    (void)I2C0_WaitIdle(I2C_INIT_DRAIN_MS);
+
     SYSCTL_RCGCI2C_R |= SYSCTL_RCGCI2C_I2C0_MASK;
     SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_GPIOB_MASK;
     (void)SYSCTL_RCGCGPIO_R;
@@ -56,21 +512,225 @@ void I2C0_Init_100k_16MHz(void)
     GPIO_PORTB_PCTL_R |=  ((0x3u << 8) | (0x3u << 12));
 
     /* Master mode */
-    I2C0_MCR_R = 0x10u;
+    I2C0_MCR_R = I2C_MCR_MFE_MASK;
+
+    /* The NVIC line stays enabled; MIMR gates it while a transfer runs */
+    I2C0_MICR_R = I2C_MICR_IC_MASK;
+    NVIC_EN0_R |= NVIC_EN0_I2C0_MASK;
 
-    /* 100 kHz @ 16 MHz -> TPR = 7 (common setting) */
-    I2C0_MTPR_R = 7u;
+    /* 100 kHz: TPR = 7 @ 16 MHz, 39 @ 80 MHz; 400 kHz: 1 and 9 */
+    s_scl_hz = scl_hz;
+    s_fail_streak = 0u;
+    I2C0_MTPR_R = I2C0_ComputeTpr(Clock_GetSysClkHz(), s_scl_hz);
+
+    (void)Clock_RegisterListener(I2C0_OnClockChange);
+    return E_OK;
 }
 
-Std_ReturnType I2C0_WriteByte(uint8_t slave_addr_7bit, uint8_t data, uint32_t timeout_ms)
+void I2C0_Init_100k(void)
+{
+    (void)I2C0_Init(I2C0_SPEED_STANDARD_HZ);
+}
+
+uint32_t I2C0_GetSpeedHz(void)
+{
+    return s_scl_hz;
+}
+
+/* One attempt each; the public calls below add retries and bookkeeping */
+static Std_ReturnType I2C0_WriteByteOnce(uint8_t slave_addr_7bit, uint8_t data, uint32_t timeout_ms)
 {
     /* MSA: [7:1]=addr, bit0=0 for write */
     I2C0_MSA_R = ((uint32_t)slave_addr_7bit << 1);
 
     I2C0_MDR_R = (uint32_t)data;
 
-    /* START + RUN + STOP */
-    I2C0_MCS_R = 0x07u;
+    I2C0_MCS_R = I2C_MCS_START | I2C_MCS_RUN | I2C_MCS_STOP;
 
     return I2C0_WaitDone(timeout_ms);
 }
+
+static Std_ReturnType I2C0_ReadByteOnce(uint8_t slave_addr_7bit, uint8_t *out, uint32_t timeout_ms)
+{
+    Std_ReturnType ret;
+
+    /* MSA: [7:1]=addr, bit0=1 for read */
+    I2C0_MSA_R = ((uint32_t)slave_addr_7bit << 1) | 1u;
+
+    /* ACK bit left clear: the only byte is NACKed, then STOP */
+    I2C0_MCS_R = I2C_MCS_START | I2C_MCS_RUN | I2C_MCS_STOP;
+
+    ret = I2C0_WaitDone(timeout_ms);
+    if (ret == E_OK)
+    {
+        *out = (uint8_t)(I2C0_MDR_R & 0xFFu);
+    }
+
+    return ret;
+}
+
+static Std_ReturnType I2C0_WriteBurstOnce(uint8_t slave_addr_7bit, const uint8_t *data, uint8_t len,
+                                          uint32_t timeout_ms)
+{
+    Std_ReturnType ret = E_OK;
+    I2C_FailKind fail;
+    uint8_t i;
+
+    I2C0_MSA_R = ((uint32_t)slave_addr_7bit << 1);
+
+    /* START/RUN, RUN..., RUN/STOP; a single byte is START/RUN/STOP */
+    for (i = 0u; (i < len) && (ret == E_OK); i++)
+    {
+        uint32_t mcs = I2C_MCS_RUN;
+
+        if (i == 0u)
+        {
+            mcs |= I2C_MCS_START;
+        }
+        if (i == (uint8_t)(len - 1u))
+        {
+            mcs |= I2C_MCS_STOP;
+        }
+
+        I2C0_MDR_R = (uint32_t)data[i];
+        I2C0_MCS_R = mcs;
+
+        ret = I2C0_WaitDone(timeout_ms);
+    }
+
+    /* NACK mid-burst leaves the bus held; release it unless arbitration was lost */
+    if ((ret != E_OK) && (i < len) && (s_last_fail == I2C_FAIL_ERROR))
+    {
+        fail = s_last_fail;
+        I2C0_MCS_R = I2C_MCS_STOP;
+        (void)I2C0_WaitDone(timeout_ms);
+        s_last_fail = fail;
+    }
+
+    return ret;
+}
+
+Std_ReturnType I2C0_WriteByte(uint8_t slave_addr_7bit, uint8_t data, uint32_t timeout_ms)
+{
+    Std_ReturnType ret = E_NOT_OK;
+    uint8_t attempt;
+
+    if (I2C0_WaitIdle(timeout_ms) != E_OK)
+    {
+        return E_NOT_OK;
+    }
+
+    PROFILE_BEGIN(PROF_ZONE_I2C_WRITEBYTE);
+
+    for (attempt = 0u; (attempt <= I2C_RETRIES) && (ret != E_OK); attempt++)
+    {
+        if (attempt > 0u)
+        {
+            I2C0_PrepareRetry(attempt);
+        }
+
+        ret = I2C0_WriteByteOnce(slave_addr_7bit, data, timeout_ms);
+        if (ret != E_OK)
+        {
+            I2C0_CountFailure(slave_addr_7bit, s_last_fail);
+        }
+    }
+    I2C0_NoteResult(ret);
+
+    PROFILE_END(PROF_ZONE_I2C_WRITEBYTE);
+    return ret;
+}
+
+Std_ReturnType I2C0_ReadByte(uint8_t slave_addr_7bit, uint8_t *out, uint32_t timeout_ms)
+{
+    Std_ReturnType ret = E_NOT_OK;
+    uint8_t attempt;
+
+    if ((out == (uint8_t *)0) || (I2C0_WaitIdle(timeout_ms) != E_OK))
+    {
+        return E_NOT_OK;
+    }
+
+    for (attempt = 0u; (attempt <= I2C_RETRIES) && (ret != E_OK); attempt++)
+    {
+        if (attempt > 0u)
+        {
+            I2C0_PrepareRetry(attempt);
+        }
+
+        ret = I2C0_ReadByteOnce(slave_addr_7bit, out, timeout_ms);
+        if (ret != E_OK)
+        {
+            I2C0_CountFailure(slave_addr_7bit, s_last_fail);
+        }
+    }
+    I2C0_NoteResult(ret);
+
+    return ret;
+}
+
+Std_ReturnType I2C0_WriteBurst(uint8_t slave_addr_7bit, const uint8_t *data, uint8_t len,
+                               uint32_t timeout_ms)
+{
+    Std_ReturnType ret = E_NOT_OK;
+    uint8_t attempt;
+
+    if ((data == (const uint8_t *)0) || (len == 0u) ||
+        (I2C0_WaitIdle(timeout_ms) != E_OK))
+    {
+        return E_NOT_OK;
+    }
+
+    PROFILE_BEGIN(PROF_ZONE_I2C_WRITEBURST);
+
+    /* A repeated burst is harmless to the LCD: it only re-strobes the
+     * nibbles the failed attempt may not have delivered */
+    for (attempt = 0u; (attempt <= I2C_RETRIES) && (ret != E_OK); attempt++)
+    {
+        if (attempt > 0u)
+        {
+            I2C0_PrepareRetry(attempt);
+        }
+
+        ret = I2C0_WriteBurstOnce(slave_addr_7bit, data, len, timeout_ms);
+        if (ret != E_OK)
+        {
+            I2C0_CountFailure(slave_addr_7bit, s_last_fail);
+        }
+    }
+    I2C0_NoteResult(ret);
+
+    PROFILE_END(PROF_ZONE_I2C_WRITEBURST);
+    return ret;
+}
+
+Std_ReturnType I2C0_GetStats(uint8_t slave_addr_7bit, I2C0_DeviceStatsType *out)
+{
+    uint8_t i;
+
+    if (out == (I2C0_DeviceStatsType *)0)
+    {
+        return E_NOT_OK;
+    }
+
+    /* A device that never failed reads as all zero */
+    out->addr = slave_addr_7bit;
+    out->errors = 0u;
+    out->timeouts = 0u;
+    out->arb_lost = 0u;
+
+    for (i = 0u; i < s_stats_used; i++)
+    {
+        if (s_stats[i].addr == slave_addr_7bit)
+        {
+            *out = s_stats[i];
+        }
+    }
+
+    return E_OK;
+}
+
+void I2C0_ClearStats(void)
+{
+    s_stats_used = 0u;
+}
@@ -4,7 +4,76 @@
 #include <stdint.h>
 #include "../Common/Std_Types.h"
 
-void I2C0_Init_100k_16MHz(void);
+#define I2C0_QUEUE_LEN          (4u)
+
+/* Bus rates accepted by I2C0_Init */
+#define I2C0_SPEED_STANDARD_HZ  (100000u)
+#define I2C0_SPEED_FAST_HZ      (400000u)
+#define I2C0_SPEED_FAST_PLUS_HZ (1000000u)
+
+/* Consecutive failed transactions before the bus drops one speed grade */
+#define I2C0_STEPDOWN_FAILURES  (3u)
+
+#define I2C0_STATS_SLOTS        (4u)
+
+/* Failed attempts per slave, retries included; saturate at 0xFFFF */
+typedef struct
+{
+    uint8_t addr;               /* 7-bit */
+    uint16_t errors;            /* NACK or bus error */
+    uint16_t timeouts;
+    uint16_t arb_lost;
+} I2C0_DeviceStatsType;
+
+/* Runs in the I2C0 ISR once the transaction has ended */
+typedef void (*I2C0_CallbackType)(Std_ReturnType result);
+
+typedef struct
+{
+    uint8_t addr;               /* 7-bit */
+    boolean read;
+    uint8_t *buf;               /* caller-owned until the callback */
+    uint8_t len;
+    I2C0_CallbackType done;     /* may be NULL */
+} I2C0_XferType;
+
+/* 100, 400 or 1000 kHz; TPR follows SYSCLK, rounded so SCL never runs
+ * fast (16 MHz tops out at 800 kHz). E_NOT_OK for any other rate. While
+ * above 100 kHz, I2C0_STEPDOWN_FAILURES failed transactions in a row
+ * (NACK, bus error, timeout) step the rate down: 1000 -> 400 -> 100. */
+Std_ReturnType I2C0_Init(uint32_t scl_hz);
+void I2C0_Init_100k(void);
+
+/* Current nominal rate, after any step-down */
+uint32_t I2C0_GetSpeedHz(void);
 Std_ReturnType I2C0_WriteByte(uint8_t slave_addr_7bit, uint8_t data, uint32_t timeout_ms);
 
+/* The blocking calls retry twice with 1 and 2 ms backoff; a timeout or
+ * lost arbitration clears the bus first. */
+
+/* Single-byte read, NACKed so the slave releases SDA */
+Std_ReturnType I2C0_ReadByte(uint8_t slave_addr_7bit, uint8_t *out, uint32_t timeout_ms);
+
+/* One START, len bytes, one STOP. timeout_ms applies per byte. */
+Std_ReturnType I2C0_WriteBurst(uint8_t slave_addr_7bit, const uint8_t *data, uint8_t len,
+                               uint32_t timeout_ms);
+
+/* Background transactions, run one after another by the I2C0 interrupt.
+ * The descriptor is copied; E_NOT_OK if the queue is full or it is empty. */
+Std_ReturnType I2C0_Submit(const I2C0_XferType *xfer);
+
+boolean I2C0_IsIdle(void);
+
+/* Wait for the queue to drain; on timeout the queue is dropped and every
+ * pending callback gets E_NOT_OK. The blocking calls above do this first. */
+Std_ReturnType I2C0_WaitIdle(uint32_t timeout_ms);
+
+/* Clock SCL until a stuck slave lets go of SDA, send STOP, restart the
+ * master. E_NOT_OK if SDA is still held low. */
+Std_ReturnType I2C0_BusRecover(void);
+
+/* Zero for an address that never failed */
+Std_ReturnType I2C0_GetStats(uint8_t slave_addr_7bit, I2C0_DeviceStatsType *out);
+void I2C0_ClearStats(void);
+
 #endif /* I2C_H_ */
@@ -0,0 +1,52 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+#include "../Common/Std_Types.h"
+
+/* 1 = instrument zones with the DWT cycle counter, 0 = compile out */
+#define PROFILE_ENABLED         (1u)
+
+/* Statically registered zones; names live in Profile.c */
+typedef enum
+{
+    PROF_ZONE_LCD_SENDCHAR = 0,
+    PROF_ZONE_KEYPAD_SCAN,
+    PROF_ZONE_I2C_WRITEBYTE,
+    PROF_ZONE_I2C_WRITEBURST,
+    PROF_ZONE_COUNT
+} Profile_ZoneId;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t total_cycles;   /* wraps after ~53 s of zone time at 80 MHz */
+    uint32_t start;
+} Profile_ZoneStats;
+
+/* Receives one formatted table line at a time, "\r\n" included */
+typedef void (*Profile_PrintFn)(const char *line);
+
+void Profile_Init(void);
+void Profile_Reset(void);
+
+void Profile_Begin(Profile_ZoneId zone);
+void Profile_End(Profile_ZoneId zone);
+
+uint32_t Profile_GetCycles(void);
+const Profile_ZoneStats *Profile_GetZone(Profile_ZoneId zone);
+
+/* name count min max total, one zone per line */
+void Profile_Dump(Profile_PrintFn print);
+
+#if (PROFILE_ENABLED == 1u)
+#define PROFILE_BEGIN(zone)     Profile_Begin(zone)
+#define PROFILE_END(zone)       Profile_End(zone)
+#else
+#define PROFILE_BEGIN(zone)     ((void)0)
+#define PROFILE_END(zone)       ((void)0)
+#endif
+
+#endif /* PROFILE_H_ */
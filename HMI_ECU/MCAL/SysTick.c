@@ -1,8 +1,7 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
 #include "SysTick.h"
-
-#define SYSTEM_CLOCK_HZ   16000000UL   // internal 16 MHz
+#include "Clock.h"
 
 void SysTick_Init(void)
 {
@@ -23,8 +22,8 @@ void SysTick_DelayMs(uint32_t ms)
 {
     for (uint32_t i = 0; i < ms; i++)
     {
-        // 1 ms at 16 MHz ? 16000 ticks
-        NVIC_ST_RELOAD_R = (SYSTEM_CLOCK_HZ / 1000U) - 1U;
+        // 1 ms = SYSCLK / 1000 ticks
+        NVIC_ST_RELOAD_R = (Clock_GetSysClkHz() / 1000U) - 1U;
         NVIC_ST_CURRENT_R = 0;  // clear current value
 
         // Wait until COUNT flag is set
@@ -1,10 +1,10 @@
 #include <stdint.h>
 #include "TM4C123GH6PM.h"
 #include "UART.h"
+#include "Clock.h"
 #include "delay.h"
 
 /* ================== CONFIG ================== */
-#define SYSCLK_HZ                   (16000000u)
 #define UART_DIV_MUL                (16u)
 
 /* Clocks */
@@ -17,6 +17,7 @@
 #define GPIO_PB01_MASK              (GPIO_PB0_MASK | GPIO_PB1_MASK)
 
 /* UART flags */
+#define UART_FR_BUSY_MASK           (1u << 3)
 #define UART_FR_TXFF_MASK           (1u << 5)
 #define UART_FR_RXFE_MASK           (1u << 4)
 
@@ -28,8 +29,11 @@
 /* UART LCRH */
 #define UART_LCRH_WLEN_8            (0x3u << 5)
 
+static uint32_t s_baudrate = 9600u;
+
 static void UART1_SetBaudRate(uint32_t baudrate)
 {
+    uint32_t sysclk = Clock_GetSysClkHz();
     uint32_t denom;
     uint32_t ibrd;
     uint32_t rem;
@@ -42,8 +46,8 @@ static void UART1_SetBaudRate(uint32_t baudrate)
 
     denom = (UART_DIV_MUL * baudrate);
 
-    ibrd = (SYSCLK_HZ / denom);
-    rem  = (SYSCLK_HZ % denom);
+    ibrd = (sysclk / denom);
+    rem  = (sysclk % denom);
 
     /* FBRD = round(rem * 64 / denom) */
     fbrd = ((rem * 64u) + (denom / 2u)) / denom;
@@ -54,6 +58,26 @@ static void UART1_SetBaudRate(uint32_t baudrate)
 
     UART1_IBRD_R = (uint16_t)ibrd;
     UART1_FBRD_R = (uint8_t)fbrd;
+
+    s_baudrate = baudrate;
+}
+
+static void UART1_OnClockChange(uint32_t sysclk_hz)
+{
+    (void)sysclk_hz;
+
+    /* Finish the frame in flight before touching the divisor */
+    while ((UART1_FR_R & UART_FR_BUSY_MASK) != 0u)
+    {
+        /* wait */
+    }
+
+    UART1_CTL_R &= ~UART_CTL_UARTEN_MASK;
+    UART1_SetBaudRate(s_baudrate);
+
+    /* Divisor change only latches on an LCRH write */
+    UART1_LCRH_R = UART_LCRH_WLEN_8;
+    UART1_CTL_R |= UART_CTL_UARTEN_MASK;
 }
 
 void UART1_Init(uint32_t baudrate)
@@ -79,6 +103,8 @@ void UART1_Init(uint32_t baudrate)
 
     UART1_CTL_R |= (UART_CTL_TXE_MASK | UART_CTL_RXE_MASK);
     UART1_CTL_R |= UART_CTL_UARTEN_MASK;
+
+    (void)Clock_RegisterListener(UART1_OnClockChange);
 }
 
 void UART1_SendByte(uint8_t data)
@@ -109,6 +135,7 @@ Std_ReturnType UART1_ReceiveByteTimeout(uint32_t timeout_ms, uint8_t *out)
     }
 
     start = Delay_GetTicksMs();
+    Delay_ArmDeadline(start + timeout_ms);
 
     while ((UART1_FR_R & UART_FR_RXFE_MASK) != 0u)
     {
@@ -119,6 +146,7 @@ Std_ReturnType UART1_ReceiveByteTimeout(uint32_t timeout_ms, uint8_t *out)
     }
 
     *out = (uint8_t)(UART1_DR_R & 0xFFu);
+    Delay_NoteActivity();
     return E_OK;
 }
 
@@ -14,6 +14,7 @@
 #include "test_config.h"
 #include "test_log.h"
 #include "../MCAL/ADC.h"
+#include "../MCAL/Delay.h"
 
 /*===========================================================================*/
 /*                           REGISTER DEFINITIONS                            */
@@ -32,6 +33,24 @@
 #define ADC_MIN_VALUE     (0u)
 #define ADC_MAX_VALUE     (4095u)
 
+/* The timeout pot's 5..30 s, one level per second */
+#define TEST_ADC_LEVELS   (26u)
+#define TEST_ADC_READS    (200u)
+
+/* 1 kHz for 10 ms: ~10 samples, fewer than the ring holds */
+#define TEST_ADC_RATE_HZ  (1000u)
+#define TEST_ADC_RUN_MS   (10u)
+#define TEST_ADC_MIN_SAMPLES (8u)
+#define TEST_ADC_MAX_SAMPLES (12u)
+#define TEST_ADC_WATCH_MS (50u)
+
+/* Bench limits: a powered board indoors */
+#define TEST_ADC_TEMP_MIN_DC  (0)
+#define TEST_ADC_TEMP_MAX_DC  (850)
+/* USB 5 V is 4.75-5.25 V; the rest covers the divider's resistors */
+#define TEST_ADC_SUPPLY_MIN_MV (4500u)
+#define TEST_ADC_SUPPLY_MAX_MV (5500u)
+
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
 /*===========================================================================*/
@@ -112,6 +131,232 @@ boolean Test_ADC_ReadTimeout_Works(void)
     return result;
 }
 
+boolean Test_ADC_Level_HoldsStill(void)
+{
+    boolean result = TRUE;
+    uint16 first = 0u;
+    uint16 level = 0u;
+    uint16 changes = 0u;
+    uint32_t i;
+    
+    /* Setup - assumes nobody touches the pot during the test */
+    ADC_Init();
+    
+    if (ADC_ReadLevel(TEST_ADC_TIMEOUT_MS, TEST_ADC_LEVELS, &first) != E_OK)
+    {
+        return FALSE;
+    }
+    
+    /* Execute */
+    for (i = 0u; i < TEST_ADC_READS; i++)
+    {
+        if (ADC_ReadLevel(TEST_ADC_TIMEOUT_MS, TEST_ADC_LEVELS, &level) != E_OK)
+        {
+            result = FALSE;
+        }
+        else if (level != first)
+        {
+            changes++;
+        }
+        else { }
+    }
+    
+    /* Verify */
+    TestLog_InfoNumeric("ADC level: ", first);
+    
+    if ((first >= TEST_ADC_LEVELS) || (changes != 0u))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_ADC_Continuous_FillsRing(void)
+{
+    boolean result = TRUE;
+    uint16 samples[ADC_RING_LEN];
+    uint16 latest = 0u;
+    uint8 count;
+    uint8 i;
+    
+    /* Setup */
+    ADC_Init();
+    
+    if (ADC_GetLatest(&latest) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Execute */
+    if (ADC_StartContinuous(TEST_ADC_RATE_HZ) != E_OK)
+    {
+        return FALSE;
+    }
+    Delay_ms(TEST_ADC_RUN_MS);
+    count = ADC_ReadSamples(samples, (uint8)ADC_RING_LEN);
+    
+    /* Verify */
+    TestLog_InfoNumeric("ADC samples in 10 ms: ", count);
+    
+    if ((count < TEST_ADC_MIN_SAMPLES) || (count > TEST_ADC_MAX_SAMPLES))
+    {
+        result = FALSE;
+    }
+    
+    for (i = 0u; i < count; i++)
+    {
+        if (samples[i] > ADC_MAX_VALUE)
+        {
+            result = FALSE;
+        }
+    }
+    
+    if ((ADC_GetLatest(&latest) != E_OK) || (latest > ADC_MAX_VALUE))
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup - software triggers work again */
+    ADC_StopContinuous();
+    
+    if (ADC_ReadTimeout(TEST_ADC_TIMEOUT_MS, &latest) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_ADC_Watch_QuietWhileStill(void)
+{
+    boolean result = TRUE;
+    uint16 samples[ADC_RING_LEN];
+    uint16 level = 0u;
+    
+    /* Setup - assumes nobody touches the pot during the test */
+    ADC_Init();
+    
+    if (ADC_WatchLevel() == E_OK)
+    {
+        /* Needs continuous mode and a level */
+        result = FALSE;
+    }
+    
+    (void)ADC_StartContinuous(TEST_ADC_RATE_HZ);
+    if (ADC_ReadLevel(TEST_ADC_TIMEOUT_MS, TEST_ADC_LEVELS, &level) != E_OK)
+    {
+        ADC_StopContinuous();
+        return FALSE;
+    }
+    
+    /* Execute */
+    if (ADC_WatchLevel() != E_OK)
+    {
+        result = FALSE;
+    }
+    (void)ADC_ReadSamples(samples, (uint8)ADC_RING_LEN);
+    Delay_ms(TEST_ADC_WATCH_MS);
+    
+    /* Verify - still watching, nothing converted into the ring */
+    if ((ADC_IsWatching() != TRUE) ||
+        (ADC_ReadSamples(samples, (uint8)ADC_RING_LEN) != 0u))
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    ADC_StopContinuous();
+    
+    if (ADC_IsWatching() != FALSE)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_ADC_Watch_WakeResumesTracking(void)
+{
+    boolean result = TRUE;
+    uint16 samples[ADC_RING_LEN];
+    uint16 level = 0u;
+    uint16 again = 0u;
+    uint16 raw;
+    
+    /* Setup - assumes nobody touches the pot during the test */
+    ADC_Init();
+    (void)ADC_StartContinuous(TEST_ADC_RATE_HZ);
+    if ((ADC_ReadLevel(TEST_ADC_TIMEOUT_MS, TEST_ADC_LEVELS, &level) != E_OK) ||
+        (ADC_WatchLevel() != E_OK))
+    {
+        ADC_StopContinuous();
+        return FALSE;
+    }
+    Delay_ms(TEST_ADC_WATCH_MS);
+    
+    /* Execute - as if the knob left the band */
+    ADC0SS2_Handler();
+    
+    /* Verify - the sample from before the watch is not handed out */
+    if ((ADC_IsWatching() != FALSE) || (ADC_GetLatest(&raw) == E_OK))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - sampling picked up again, same level for a still knob */
+    (void)ADC_ReadSamples(samples, (uint8)ADC_RING_LEN);
+    Delay_ms(TEST_ADC_RUN_MS);
+    if ((ADC_GetLatest(&raw) != E_OK) ||
+        (ADC_ReadSamples(samples, (uint8)ADC_RING_LEN) < TEST_ADC_MIN_SAMPLES) ||
+        (ADC_ReadLevel(TEST_ADC_TIMEOUT_MS, TEST_ADC_LEVELS, &again) != E_OK) ||
+        (again != level))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - and the watch can be armed again */
+    if ((ADC_WatchLevel() != E_OK) || (ADC_IsWatching() != TRUE))
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    ADC_StopContinuous();
+    
+    return result;
+}
+
+boolean Test_ADC_Snapshot_Plausible(void)
+{
+    boolean result = TRUE;
+    ADC_SnapshotType snap;
+    
+    /* Setup */
+    ADC_Init();
+    
+    /* Execute */
+    if (ADC_ReadSnapshot(TEST_ADC_TIMEOUT_MS, &snap) != E_OK)
+    {
+        return FALSE;
+    }
+    
+    /* Verify */
+    TestLog_InfoNumeric("ADC supply mV: ", snap.supply_mv);
+    TestLog_InfoNumeric("ADC temp 0.1C: ", (uint32_t)snap.temp_dc);
+    
+    if ((snap.pot > ADC_MAX_VALUE) ||
+        (snap.supply_mv < TEST_ADC_SUPPLY_MIN_MV) ||
+        (snap.supply_mv > TEST_ADC_SUPPLY_MAX_MV) ||
+        (snap.temp_dc < TEST_ADC_TEMP_MIN_DC) ||
+        (snap.temp_dc > TEST_ADC_TEMP_MAX_DC))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
 void Test_ADC_RunAll(void)
 {
     TestLog_SuiteStart(ADC_SUITE);
@@ -119,6 +364,11 @@ void Test_ADC_RunAll(void)
     TEST_RUN(ADC_SUITE, "Init_EnablesSS3", Test_ADC_Init_EnablesSS3);
     TEST_RUN(ADC_SUITE, "Read_InValidRange", Test_ADC_Read_InValidRange);
     TEST_RUN(ADC_SUITE, "ReadTimeout_Works", Test_ADC_ReadTimeout_Works);
+    TEST_RUN(ADC_SUITE, "Level_HoldsStill", Test_ADC_Level_HoldsStill);
+    TEST_RUN(ADC_SUITE, "Continuous_FillsRing", Test_ADC_Continuous_FillsRing);
+    TEST_RUN(ADC_SUITE, "Watch_QuietWhileStill", Test_ADC_Watch_QuietWhileStill);
+    TEST_RUN(ADC_SUITE, "Watch_WakeResumesTracking", Test_ADC_Watch_WakeResumesTracking);
+    TEST_RUN(ADC_SUITE, "Snapshot_Plausible", Test_ADC_Snapshot_Plausible);
     
     TestLog_SuiteEnd(ADC_SUITE);
 }
@@ -36,4 +36,38 @@ boolean Test_ADC_Read_InValidRange(void);
  */
 boolean Test_ADC_ReadTimeout_Works(void);
 
+/**
+ * @brief Test a still pot reads one filtered level throughout
+ * @return TRUE if passed
+ */
+boolean Test_ADC_Level_HoldsStill(void);
+
+/**
+ * @brief Test timer-triggered sampling fills the ring at the set rate
+ *        and ADC_GetLatest does not wait
+ * @return TRUE if passed
+ */
+boolean Test_ADC_Continuous_FillsRing(void);
+
+/**
+ * @brief Test the comparator watch holds while the pot is still: no
+ *        samples reach the CPU until it is stopped
+ * @return TRUE if passed
+ */
+boolean Test_ADC_Watch_QuietWhileStill(void);
+
+/**
+ * @brief Test a comparator wake drops the pre-watch sample, resumes
+ *        sampling at the same level and lets the watch be armed again
+ * @return TRUE if passed
+ */
+boolean Test_ADC_Watch_WakeResumesTracking(void);
+
+/**
+ * @brief Test one snapshot returns the pot, supply and a plausible die
+ *        temperature
+ * @return TRUE if passed
+ */
+boolean Test_ADC_Snapshot_Plausible(void);
+
 #endif /* TEST_CASES_DRIVER_ADC_H */
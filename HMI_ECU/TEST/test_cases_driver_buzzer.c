@@ -14,6 +14,7 @@
 #include "test_config.h"
 #include "test_log.h"
 #include "../HAL/Buzzer.h"
+#include "../MCAL/Delay.h"
 
 /*===========================================================================*/
 /*                           REGISTER DEFINITIONS                            */
@@ -28,6 +29,11 @@
 /* Buzzer pin mask - adjust based on hardware */
 #define BUZZER_PIN_MASK       (0x04u)  /* Assumed PF2 */
 
+/* Two 100 ms notes; queueing them takes no measurable time */
+#define TEST_TUNE_MS          (200u)
+#define TEST_TUNE_MARGIN_MS   (20u)
+#define TEST_PLAY_MAX_MS      (1u)
+
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
 /*===========================================================================*/
@@ -95,6 +101,57 @@ boolean Test_Buzzer_BeepShort_Works(void)
     return result;
 }
 
+boolean Test_Buzzer_Play_DoesNotBlock(void)
+{
+    boolean result = TRUE;
+    static const Buzzer_NoteType tune[2] = { { 1000u, 100u }, { 1500u, 100u } };
+    Buzzer_NoteType big[BUZZER_QUEUE_LEN];
+    uint32_t start;
+    uint32_t elapsed;
+    uint8_t i;
+    
+    /* Setup */
+    Buzzer_Init();
+    
+    for (i = 0u; i < BUZZER_QUEUE_LEN; i++)
+    {
+        big[i] = tune[0];
+    }
+    
+    /* Execute */
+    start = Delay_GetTicksMs();
+    if (Buzzer_Play(tune, 2u) != E_OK)
+    {
+        result = FALSE;
+    }
+    elapsed = Delay_GetTicksMs() - start;
+    
+    /* Verify - back at once, still sounding, a tune too long refused */
+    TestLog_InfoNumeric("Buzzer_Play ms: ", elapsed);
+    
+    if ((elapsed > TEST_PLAY_MAX_MS) || (Buzzer_IsPlaying() != TRUE))
+    {
+        result = FALSE;
+    }
+    
+    if (Buzzer_Play(big, (uint8_t)BUZZER_QUEUE_LEN) != E_NOT_OK)
+    {
+        result = FALSE;
+    }
+    
+    Delay_ms(TEST_TUNE_MS + TEST_TUNE_MARGIN_MS);
+    
+    if (Buzzer_IsPlaying() != FALSE)
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    Buzzer_Stop();
+    
+    return result;
+}
+
 void Test_Buzzer_RunAll(void)
 {
     TestLog_SuiteStart(BUZZER_SUITE);
@@ -102,6 +159,7 @@ void Test_Buzzer_RunAll(void)
     TEST_RUN(BUZZER_SUITE, "Init_ConfiguresGPIO", Test_Buzzer_Init_ConfiguresGPIO);
     TEST_RUN(BUZZER_SUITE, "OnOff_Works", Test_Buzzer_OnOff_Works);
     TEST_RUN(BUZZER_SUITE, "BeepShort_Works", Test_Buzzer_BeepShort_Works);
+    TEST_RUN(BUZZER_SUITE, "Play_DoesNotBlock", Test_Buzzer_Play_DoesNotBlock);
     
     TestLog_SuiteEnd(BUZZER_SUITE);
 }
@@ -36,4 +36,11 @@ boolean Test_Buzzer_OnOff_Works(void);
  */
 boolean Test_Buzzer_BeepShort_Works(void);
 
+/**
+ * @brief Test a queued tune returns at once, plays in the background and
+ *        a tune that does not fit is refused
+ * @return TRUE if passed
+ */
+boolean Test_Buzzer_Play_DoesNotBlock(void);
+
 #endif /* TEST_CASES_DRIVER_BUZZER_H */
@@ -0,0 +1,39 @@
+/**
+ * @file    test_cases_driver_clock.h
+ * @brief   Clock Driver Unit Tests - HMI ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#ifndef TEST_CASES_DRIVER_CLOCK_H
+#define TEST_CASES_DRIVER_CLOCK_H
+
+#include "../Common/Std_Types.h"
+
+/**
+ * @brief Run all Clock unit tests
+ */
+void Test_Clock_RunAll(void);
+
+/**
+ * @brief Test 80 MHz PLL rescales SysTick, UART and I2C dividers
+ * @return TRUE if passed
+ */
+boolean Test_Clock_Pll80_RescalesDrivers(void);
+
+/**
+ * @brief Test return to 16 MHz restores the reset dividers
+ * @return TRUE if passed
+ */
+boolean Test_Clock_Back16_RestoresDrivers(void);
+
+/**
+ * @brief Test unsupported frequency is rejected and clock unchanged
+ * @return TRUE if passed
+ */
+boolean Test_Clock_Unsupported_Rejected(void);
+
+#endif /* TEST_CASES_DRIVER_CLOCK_H */
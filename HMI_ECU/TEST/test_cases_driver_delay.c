@@ -25,6 +25,10 @@
 /* Test delay duration */
 #define TEST_DELAY_MS             (100u)
 
+/* Microsecond waits: short steps summed up to a tick-measurable span */
+#define TEST_DELAY_US_STEP        (250u)
+#define TEST_DELAY_US_STEPS       (400u)    /* 100 ms */
+
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
 /*===========================================================================*/
@@ -42,7 +46,7 @@ boolean Test_Delay_TickCounter_Increments(void)
     uint32_t ticksAfter;
     
     /* Ensure timer is initialized */
-    Delay_Init_16MHz();
+    Delay_Init();
     
     /* Record initial ticks */
     ticksBefore = Delay_GetTicksMs();
@@ -71,7 +75,7 @@ boolean Test_Delay_Ms_Accuracy(void)
     uint32_t maxExpected;
     
     /* Ensure timer is initialized */
-    Delay_Init_16MHz();
+    Delay_Init();
     
     /* Calculate tolerance bounds */
     minExpected = TEST_DELAY_MS - ((TEST_DELAY_MS * DELAY_TOLERANCE_PERCENT) / 100u);
@@ -98,12 +102,49 @@ boolean Test_Delay_Ms_Accuracy(void)
     return result;
 }
 
+boolean Test_Delay_Us_Accuracy(void)
+{
+    boolean result = TRUE;
+    uint32_t ticksBefore;
+    uint32_t elapsed;
+    uint32_t expected;
+    uint32_t i;
+    
+    /* Setup */
+    Delay_Init();
+    expected = (TEST_DELAY_US_STEP * TEST_DELAY_US_STEPS) / 1000u;
+    
+    /* Execute - each step spans SysTick wraps at arbitrary phase */
+    ticksBefore = Delay_GetTicksMs();
+    for (i = 0u; i < TEST_DELAY_US_STEPS; i++)
+    {
+        Delay_us(TEST_DELAY_US_STEP);
+    }
+    elapsed = Delay_GetTicksMs() - ticksBefore;
+    
+    /* Verify - virtual time does not count microseconds */
+    TestLog_InfoNumeric("Delay_us total ms: ", elapsed);
+    
+#if !defined(DELAY_VIRTUAL_TIME)
+    if ((elapsed < (expected - ((expected * DELAY_TOLERANCE_PERCENT) / 100u))) ||
+        (elapsed > (expected + ((expected * DELAY_TOLERANCE_PERCENT) / 100u))))
+    {
+        result = FALSE;
+    }
+#else
+    (void)expected;
+#endif
+    
+    return result;
+}
+
 void Test_Delay_RunAll(void)
 {
     TestLog_SuiteStart(DELAY_SUITE);
     
     TEST_RUN(DELAY_SUITE, "TickCounter_Increments", Test_Delay_TickCounter_Increments);
     TEST_RUN(DELAY_SUITE, "Ms_Accuracy", Test_Delay_Ms_Accuracy);
+    TEST_RUN(DELAY_SUITE, "Us_Accuracy", Test_Delay_Us_Accuracy);
     
     TestLog_SuiteEnd(DELAY_SUITE);
 }
@@ -30,4 +30,10 @@ boolean Test_Delay_TickCounter_Increments(void);
  */
 boolean Test_Delay_Ms_Accuracy(void);
 
+/**
+ * @brief Test Delay_us adds up to the right number of milliseconds
+ * @return TRUE if passed
+ */
+boolean Test_Delay_Us_Accuracy(void);
+
 #endif /* TEST_CASES_DRIVER_DELAY_H */
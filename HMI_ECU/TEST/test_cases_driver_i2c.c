@@ -14,6 +14,7 @@
 #include "test_config.h"
 #include "test_log.h"
 #include "../MCAL/I2C.h"
+#include "../MCAL/Clock.h"
 
 /*===========================================================================*/
 /*                           REGISTER DEFINITIONS                            */
@@ -29,6 +30,20 @@
 
 /* Invalid I2C address for testing */
 #define TEST_INVALID_I2C_ADDR   (0x7Eu)
+#define TEST_UNUSED_I2C_ADDR    (0x7Du)
+
+/*===========================================================================*/
+/*                           TEST STATE                                      */
+/*===========================================================================*/
+
+static volatile uint8_t s_test_done_count = 0u;
+static volatile Std_ReturnType s_test_done_result = E_OK;
+
+static void Test_I2C_OnDone(Std_ReturnType result)
+{
+    s_test_done_result = result;
+    s_test_done_count++;
+}
 
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
@@ -47,7 +62,7 @@ boolean Test_I2C_Init_ConfiguresMaster(void)
     uint32_t mtpr;
     
     /* Execute */
-    I2C0_Init_100k_16MHz();
+    I2C0_Init_100k();
     
     /* Verify Master Function Enable is set */
     mcr = I2C0_MCR_R;
@@ -75,7 +90,7 @@ boolean Test_I2C_Write_InvalidAddress_Timeout(void)
     Std_ReturnType retVal;
     
     /* Ensure I2C is initialized */
-    I2C0_Init_100k_16MHz();
+    I2C0_Init_100k();
     
     /* Execute - write to non-existent device should fail */
     retVal = I2C0_WriteByte(TEST_INVALID_I2C_ADDR, 0x00u, 100u);
@@ -90,12 +105,282 @@ boolean Test_I2C_Write_InvalidAddress_Timeout(void)
     return result;
 }
 
+boolean Test_I2C_Burst_InvalidAddress_Fails(void)
+{
+    boolean result = TRUE;
+    const uint8_t burst[3] = { 0x00u, 0x04u, 0x00u };
+    
+    /* Ensure I2C is initialized */
+    I2C0_Init_100k();
+    
+    /* Execute - NACK on the address phase must end the burst */
+    if (I2C0_WriteBurst(TEST_INVALID_I2C_ADDR, burst, 3u, 100u) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - bus released, the controller is idle again */
+    if ((I2C0_MCS_R & 0x01u) != 0u)
+    {
+        result = FALSE;
+    }
+    
+    /* Empty burst is rejected without touching the bus */
+    if (I2C0_WriteBurst(TEST_INVALID_I2C_ADDR, burst, 0u, 100u) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_I2C_Read_InvalidAddress_Fails(void)
+{
+    boolean result = TRUE;
+    uint8_t value = 0x5Au;
+    
+    /* Ensure I2C is initialized */
+    I2C0_Init_100k();
+    
+    /* Execute - address NACK, nothing may be stored */
+    if (I2C0_ReadByte(TEST_INVALID_I2C_ADDR, &value, 100u) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    if (value != 0x5Au)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - bus released */
+    if ((I2C0_MCS_R & 0x01u) != 0u)
+    {
+        result = FALSE;
+    }
+    
+    /* Null destination is rejected */
+    if (I2C0_ReadByte(TEST_INVALID_I2C_ADDR, (uint8_t *)0, 100u) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_I2C_Queue_InvalidAddress_CallsBack(void)
+{
+    boolean result = TRUE;
+    uint8_t data[2] = { 0x00u, 0x08u };
+    I2C0_XferType xfer;
+    
+    /* Setup */
+    I2C0_Init_100k();
+    s_test_done_count = 0u;
+    
+    xfer.addr = TEST_INVALID_I2C_ADDR;
+    xfer.read = FALSE;
+    xfer.buf  = data;
+    xfer.len  = 2u;
+    xfer.done = Test_I2C_OnDone;
+    
+    /* Execute - two queued, both NACKed in the background */
+    if ((I2C0_Submit(&xfer) != E_OK) || (I2C0_Submit(&xfer) != E_OK))
+    {
+        result = FALSE;
+    }
+    
+    if (I2C0_WaitIdle(100u) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - one callback each, with the failure */
+    if ((s_test_done_count != 2u) || (s_test_done_result != E_NOT_OK))
+    {
+        result = FALSE;
+    }
+    
+    if ((I2C0_MCS_R & 0x01u) != 0u)
+    {
+        result = FALSE;
+    }
+    
+    /* Empty transaction is rejected */
+    xfer.len = 0u;
+    if (I2C0_Submit(&xfer) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_I2C_Init_SpeedGrades(void)
+{
+    boolean result = TRUE;
+    uint32_t sysclk = Clock_GetSysClkHz();
+    uint32_t div;
+    uint32_t exp_tpr;
+    
+    /* Execute - 400 kHz: smallest TPR with SCL <= 400 kHz */
+    if (I2C0_Init(I2C0_SPEED_FAST_HZ) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    div = 20u * I2C0_SPEED_FAST_HZ;
+    exp_tpr = ((sysclk + div - 1u) / div) - 1u;
+    
+    /* Verify */
+    if ((I2C0_MTPR_R != exp_tpr) || (I2C0_GetSpeedHz() != I2C0_SPEED_FAST_HZ))
+    {
+        result = FALSE;
+    }
+    
+    if (I2C0_Init(I2C0_SPEED_FAST_PLUS_HZ) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Unsupported rate is rejected and leaves the bus as it was */
+    if ((I2C0_Init(250000u) == E_OK) || (I2C0_GetSpeedHz() != I2C0_SPEED_FAST_PLUS_HZ))
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    I2C0_Init_100k();
+    
+    return result;
+}
+
+boolean Test_I2C_StepDown_OnRepeatedNack(void)
+{
+    boolean result = TRUE;
+    uint8_t i;
+    
+    /* Setup */
+    (void)I2C0_Init(I2C0_SPEED_FAST_PLUS_HZ);
+    
+    /* Execute - one streak per speed grade */
+    for (i = 0u; i < I2C0_STEPDOWN_FAILURES; i++)
+    {
+        (void)I2C0_WriteByte(TEST_INVALID_I2C_ADDR, 0x00u, 100u);
+    }
+    
+    if (I2C0_GetSpeedHz() != I2C0_SPEED_FAST_HZ)
+    {
+        result = FALSE;
+    }
+    
+    for (i = 0u; i < I2C0_STEPDOWN_FAILURES; i++)
+    {
+        (void)I2C0_WriteByte(TEST_INVALID_I2C_ADDR, 0x00u, 100u);
+    }
+    
+    /* Verify - floor is standard mode */
+    if (I2C0_GetSpeedHz() != I2C0_SPEED_STANDARD_HZ)
+    {
+        result = FALSE;
+    }
+    
+    (void)I2C0_WriteByte(TEST_INVALID_I2C_ADDR, 0x00u, 100u);
+    if (I2C0_GetSpeedHz() != I2C0_SPEED_STANDARD_HZ)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_I2C_Stats_CountPerAddress(void)
+{
+    boolean result = TRUE;
+    I2C0_DeviceStatsType stats;
+    
+    /* Setup */
+    I2C0_Init_100k();
+    I2C0_ClearStats();
+    
+    /* Execute - one call, every retry NACKed */
+    (void)I2C0_WriteByte(TEST_INVALID_I2C_ADDR, 0x00u, 100u);
+    
+    /* Verify - attempts counted as errors, not timeouts */
+    if (I2C0_GetStats(TEST_INVALID_I2C_ADDR, &stats) != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    TestLog_InfoNumeric("I2C NACKs counted: ", stats.errors);
+    if ((stats.errors < 2u) || (stats.timeouts != 0u) || (stats.arb_lost != 0u))
+    {
+        result = FALSE;
+    }
+    
+    /* Other addresses untouched */
+    (void)I2C0_GetStats(TEST_UNUSED_I2C_ADDR, &stats);
+    if ((stats.errors != 0u) || (stats.timeouts != 0u))
+    {
+        result = FALSE;
+    }
+    
+    /* Cleared */
+    I2C0_ClearStats();
+    (void)I2C0_GetStats(TEST_INVALID_I2C_ADDR, &stats);
+    if (stats.errors != 0u)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_I2C_BusRecover_IdleBus(void)
+{
+    boolean result = TRUE;
+    
+    /* Setup */
+    I2C0_Init_100k();
+    
+    /* Execute - nothing is holding SDA, so the clear must succeed */
+    if (I2C0_BusRecover() != E_OK)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - controller handed back in master mode and usable */
+    if ((I2C0_MCR_R & I2C_MCR_MFE) == 0u)
+    {
+        result = FALSE;
+    }
+    
+    if (I2C0_WriteByte(TEST_INVALID_I2C_ADDR, 0x00u, 100u) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    if ((I2C0_MCS_R & 0x01u) != 0u)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
 void Test_I2C_RunAll(void)
 {
     TestLog_SuiteStart(I2C_SUITE);
     
     TEST_RUN(I2C_SUITE, "Init_ConfiguresMaster", Test_I2C_Init_ConfiguresMaster);
     TEST_RUN(I2C_SUITE, "Write_InvalidAddress_Timeout", Test_I2C_Write_InvalidAddress_Timeout);
+    TEST_RUN(I2C_SUITE, "Burst_InvalidAddress_Fails", Test_I2C_Burst_InvalidAddress_Fails);
+    TEST_RUN(I2C_SUITE, "Read_InvalidAddress_Fails", Test_I2C_Read_InvalidAddress_Fails);
+    TEST_RUN(I2C_SUITE, "Queue_InvalidAddress_CallsBack", Test_I2C_Queue_InvalidAddress_CallsBack);
+    TEST_RUN(I2C_SUITE, "Init_SpeedGrades", Test_I2C_Init_SpeedGrades);
+    TEST_RUN(I2C_SUITE, "StepDown_OnRepeatedNack", Test_I2C_StepDown_OnRepeatedNack);
+    TEST_RUN(I2C_SUITE, "Stats_CountPerAddress", Test_I2C_Stats_CountPerAddress);
+    TEST_RUN(I2C_SUITE, "BusRecover_IdleBus", Test_I2C_BusRecover_IdleBus);
     
     TestLog_SuiteEnd(I2C_SUITE);
 }
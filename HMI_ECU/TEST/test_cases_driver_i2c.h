@@ -30,4 +30,46 @@ boolean Test_I2C_Init_ConfiguresMaster(void);
  */
 boolean Test_I2C_Write_InvalidAddress_Timeout(void);
 
+/**
+ * @brief Test I2C0 burst write to invalid address fails and frees the bus
+ * @return TRUE if passed
+ */
+boolean Test_I2C_Burst_InvalidAddress_Fails(void);
+
+/**
+ * @brief Test I2C0 single-byte read from invalid address fails
+ * @return TRUE if passed
+ */
+boolean Test_I2C_Read_InvalidAddress_Fails(void);
+
+/**
+ * @brief Test queued I2C0 transactions to invalid address call back with failure
+ * @return TRUE if passed
+ */
+boolean Test_I2C_Queue_InvalidAddress_CallsBack(void);
+
+/**
+ * @brief Test I2C0_Init TPR for each speed grade and rejection of others
+ * @return TRUE if passed
+ */
+boolean Test_I2C_Init_SpeedGrades(void);
+
+/**
+ * @brief Test repeated NACKs step the bus down to 100 kHz and no further
+ * @return TRUE if passed
+ */
+boolean Test_I2C_StepDown_OnRepeatedNack(void);
+
+/**
+ * @brief Test NACKs are counted against the failing address only
+ * @return TRUE if passed
+ */
+boolean Test_I2C_Stats_CountPerAddress(void);
+
+/**
+ * @brief Test bus clear on an idle bus succeeds and leaves the master usable
+ * @return TRUE if passed
+ */
+boolean Test_I2C_BusRecover_IdleBus(void);
+
 #endif /* TEST_CASES_DRIVER_I2C_H */
@@ -5,7 +5,8 @@
  * @target  TM4C123GH6PM
  * @version 1.0
  * 
- * @details Tests keypad GPIO configuration and timeout behavior.
+ * @details Tests keypad GPIO configuration, timeout behavior and the
+ *          per-key debounce state machine.
  * 
  * MISRA-C:2012 Compliant
  */
@@ -14,6 +15,8 @@
 #include "test_config.h"
 #include "test_log.h"
 #include "../HAL/keypad.h"
+#include "../MCAL/Delay.h"
+#include "../APP/TypeAhead.h"
 
 /*===========================================================================*/
 /*                           REGISTER DEFINITIONS                            */
@@ -23,14 +26,38 @@
 #define GPIO_PORTD_DIR_R      (*((volatile uint32_t *)0x40007400u))
 #define GPIO_PORTD_DEN_R      (*((volatile uint32_t *)0x4000751Cu))
 #define GPIO_PORTD_PUR_R      (*((volatile uint32_t *)0x40007510u))
+#define GPIO_PORTD_DATA_R     (*((volatile uint32_t *)0x400073FCu))
 
 /* GPIO Port E Registers (Keypad Columns) */
 #define GPIO_PORTE_DIR_R      (*((volatile uint32_t *)0x40024400u))
 #define GPIO_PORTE_DEN_R      (*((volatile uint32_t *)0x4002451Cu))
+#define GPIO_PORTE_IS_R       (*((volatile uint32_t *)0x40024404u))
+#define GPIO_PORTE_IEV_R      (*((volatile uint32_t *)0x4002440Cu))
+#define GPIO_PORTE_IM_R       (*((volatile uint32_t *)0x40024410u))
+
+/* Timer2 (scan tick) */
+#define TIMER2_CTL_R          (*((volatile uint32_t *)0x4003200Cu))
+#define TIMER_CTL_TAEN        (0x01u)
 
 /* Keypad masks */
 #define KEYPAD_ROWS_MASK      (0x0Fu)  /* PD0-PD3 */
 #define KEYPAD_COLS_MASK      (0x0Fu)  /* PE0-PE3 */
+#define KEYPAD_COL_IRQ_MASK   (0x1Eu)  /* PE1-PE4 */
+
+/* Idle polls: each used to cost four 1 ms row settles */
+#define TEST_IDLE_POLLS       (20u)
+#define TEST_IDLE_POLLS_MAX_MS (2u)
+
+/* A debounce window and a few ticks more for the scan tick to stop */
+#define TEST_SETTLE_MS        (KEYPAD_DEBOUNCE_MS + (4u * KEYPAD_TICK_MS))
+
+/* Discard window after a TA_FLUSH in the type-ahead tests */
+#define TEST_TA_WINDOW_MS     (100u)
+
+/* State machine timing in scan ticks, as keypad.c derives it */
+#define TEST_DEBOUNCE_TICKS   (KEYPAD_DEBOUNCE_MS / KEYPAD_TICK_MS)
+#define TEST_LONG_TICKS       (KEYPAD_LONG_MS / KEYPAD_TICK_MS)
+#define TEST_REPEAT_TICKS     (KEYPAD_REPEAT_MS / KEYPAD_TICK_MS)
 
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
@@ -38,6 +65,53 @@
 
 #define KEYPAD_SUITE      "Keypad"
 
+/*===========================================================================*/
+/*                           HELPER FUNCTIONS                                */
+/*===========================================================================*/
+
+/* What the keypad ISR would queue for one press */
+static void Test_TypeAhead_Press(char key, uint32_t time_ms)
+{
+    Keypad_EventType ev;
+    
+    ev.key = key;
+    ev.kind = KEYPAD_EV_PRESS;
+    ev.keys = Keypad_KeyMask(key);
+    ev.time_ms = time_ms;
+    TypeAhead_Push(&ev);
+}
+
+/* The same raw scan for a number of ticks */
+static void Test_Keypad_Feed(uint16_t down, uint16_t ticks)
+{
+    uint16_t i;
+    
+    for (i = 0u; i < ticks; i++)
+    {
+        Keypad_InjectScan(down);
+    }
+}
+
+/* TRUE if the next queued event is kind on key with keys down after it */
+static boolean Test_Keypad_Expect(Keypad_EventKind kind, char key, uint16_t keys)
+{
+    Keypad_EventType ev;
+    
+    if (Keypad_GetEvent(&ev) != E_OK)
+    {
+        return FALSE;
+    }
+    
+    return ((ev.kind == kind) && (ev.key == key) && (ev.keys == keys)) ? TRUE : FALSE;
+}
+
+static boolean Test_Keypad_QueueEmpty(void)
+{
+    Keypad_EventType ev;
+    
+    return (Keypad_GetEvent(&ev) == E_OK) ? FALSE : TRUE;
+}
+
 /*===========================================================================*/
 /*                           TEST IMPLEMENTATIONS                            */
 /*===========================================================================*/
@@ -106,12 +180,361 @@ boolean Test_Keypad_Timeout_NoKey_ReturnsNotOK(void)
     return result;
 }
 
+boolean Test_Keypad_Idle_RowsLowAndArmed(void)
+{
+    boolean result = TRUE;
+    
+    /* Execute */
+    Keypad_Init();
+    
+    /* Verify - rows low, columns unmasked for falling edges */
+    if ((GPIO_PORTD_DATA_R & KEYPAD_ROWS_MASK) != 0u)
+    {
+        result = FALSE;
+    }
+    
+    if (((GPIO_PORTE_IM_R & KEYPAD_COL_IRQ_MASK) != KEYPAD_COL_IRQ_MASK) ||
+        ((GPIO_PORTE_IS_R & KEYPAD_COL_IRQ_MASK) != 0u) ||
+        ((GPIO_PORTE_IEV_R & KEYPAD_COL_IRQ_MASK) != 0u))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_Idle_PollIsFree(void)
+{
+    boolean result = TRUE;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t i;
+    char key = '\0';
+    
+    /* Setup - assumes no key is being pressed during test */
+    Keypad_Init();
+    
+    /* Execute - no column edge, so no scan */
+    start = Delay_GetTicksMs();
+    for (i = 0u; i < TEST_IDLE_POLLS; i++)
+    {
+        (void)Keypad_GetKeyTimeout(0u, &key);
+    }
+    elapsed = Delay_GetTicksMs() - start;
+    
+    /* Verify */
+    TestLog_InfoNumeric("Keypad idle polls ms: ", elapsed);
+    
+    if (elapsed > TEST_IDLE_POLLS_MAX_MS)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_SpuriousEdge_NoEvent(void)
+{
+    boolean result = TRUE;
+    Keypad_EventType ev;
+    
+    /* Setup - assumes no key is being pressed during test */
+    Keypad_Init();
+    
+    /* Execute - a column edge with no key behind it */
+    GPIOE_Handler();
+    
+    if ((TIMER2_CTL_R & TIMER_CTL_TAEN) == 0u)
+    {
+        result = FALSE;
+    }
+    
+    Delay_ms(TEST_SETTLE_MS);
+    
+    /* Verify - nothing debounced, tick stopped, edges armed again */
+    if (Keypad_GetEvent(&ev) == E_OK)
+    {
+        result = FALSE;
+    }
+    
+    if (((TIMER2_CTL_R & TIMER_CTL_TAEN) != 0u) ||
+        ((GPIO_PORTE_IM_R & KEYPAD_COL_IRQ_MASK) != KEYPAD_COL_IRQ_MASK))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_Ghost_RectangleAmbiguous(void)
+{
+    boolean result = TRUE;
+    const uint16_t k1 = Keypad_KeyMask('1');
+    const uint16_t k2 = Keypad_KeyMask('2');
+    const uint16_t k4 = Keypad_KeyMask('4');
+    const uint16_t k5 = Keypad_KeyMask('5');
+    const uint16_t k9 = Keypad_KeyMask('9');
+    const uint16_t chord = (uint16_t)(Keypad_KeyMask('*') | Keypad_KeyMask('#'));
+    
+    /* Verify - every key has its own bit */
+    if ((k1 == 0u) || (k2 == 0u) || (k4 == 0u) || (k5 == 0u) || (k9 == 0u) ||
+        (Keypad_KeyMask('*') == Keypad_KeyMask('#')) || (Keypad_KeyMask('x') != 0u))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - 1, 2, 4 read with 5 as a phantom */
+    if (Keypad_IsAmbiguous((uint16_t)(k1 | k2 | k4 | k5)) != TRUE)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - no two rows share two columns */
+    if ((Keypad_IsAmbiguous((uint16_t)(k1 | k2 | k4)) != FALSE) ||
+        (Keypad_IsAmbiguous((uint16_t)(k1 | k5 | k9)) != FALSE) ||
+        (Keypad_IsAmbiguous(chord) != FALSE))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_TypeAhead_Overflow(void)
+{
+    boolean result = TRUE;
+    const char typed[] = "1234567";
+    const uint32_t now = Delay_GetTicksMs();
+    Keypad_EventType ev;
+    uint8_t i;
+    char k;
+    
+    /* Setup */
+    TypeAhead_Flush(0u);
+    
+    /* Execute - one press more than fits; a release is not a press */
+    for (i = 0u; i <= TYPEAHEAD_LEN; i++)
+    {
+        Test_TypeAhead_Press(typed[i], now);
+    }
+    ev.key = '1';
+    ev.kind = KEYPAD_EV_RELEASE;
+    ev.keys = 0u;
+    ev.time_ms = now;
+    TypeAhead_Push(&ev);
+    
+    if (TypeAhead_Count() != TYPEAHEAD_LEN)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - the first TYPEAHEAD_LEN come out in order, the newest was dropped */
+    for (i = 0u; i < TYPEAHEAD_LEN; i++)
+    {
+        if ((TypeAhead_Take(&k) == FALSE) || (k != typed[i]))
+        {
+            result = FALSE;
+        }
+    }
+    
+    if ((TypeAhead_Take(&k) != FALSE) || (TypeAhead_Count() != 0u))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - a press older than TYPEAHEAD_MAX_AGE_MS is skipped */
+    Test_TypeAhead_Press('8', now - (TYPEAHEAD_MAX_AGE_MS + 1u));
+    Test_TypeAhead_Press('9', now);
+    if ((TypeAhead_Take(&k) == FALSE) || (k != '9'))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_TypeAhead_FlushVsKeep(void)
+{
+    boolean result = TRUE;
+    char k;
+    
+    /* Setup */
+    TypeAhead_Flush(0u);
+    
+    /* Execute - TA_KEEP: what was typed under the message stays */
+    Test_TypeAhead_Press('1', Delay_GetTicksMs());
+    Test_TypeAhead_Press('2', Delay_GetTicksMs());
+    if ((TypeAhead_Take(&k) == FALSE) || (k != '1') ||
+        (TypeAhead_Take(&k) == FALSE) || (k != '2'))
+    {
+        result = FALSE;
+    }
+    
+    /* Execute - TA_FLUSH: held keys go, and so do presses in the window */
+    Test_TypeAhead_Press('3', Delay_GetTicksMs());
+    TypeAhead_Flush(TEST_TA_WINDOW_MS);
+    Test_TypeAhead_Press('4', Delay_GetTicksMs());
+    if ((TypeAhead_Count() != 0u) || (TypeAhead_Take(&k) != FALSE))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - a press after the window is kept */
+    Delay_ms(TEST_TA_WINDOW_MS);
+    Test_TypeAhead_Press('5', Delay_GetTicksMs());
+    if ((TypeAhead_Take(&k) == FALSE) || (k != '5'))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_Step_PressLongRepeatRelease(void)
+{
+    boolean result = TRUE;
+    const uint16_t k5 = Keypad_KeyMask('5');
+    
+    /* Setup - assumes no key is being pressed during test */
+    Keypad_Init();
+    
+    /* Execute - one-tick bounces never reach PRESS */
+    Keypad_InjectScan(k5);
+    Keypad_InjectScan(0u);
+    Keypad_InjectScan(k5);
+    Keypad_InjectScan(0u);
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - PRESS on the DEBOUNCE_TICKS-th stable tick, not before */
+    Test_Keypad_Feed(k5, (uint16_t)(TEST_DEBOUNCE_TICKS - 1u));
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    Keypad_InjectScan(k5);
+    if ((Test_Keypad_Expect(KEYPAD_EV_PRESS, '5', k5) == FALSE) ||
+        (Test_Keypad_QueueEmpty() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - LONG after KEYPAD_LONG_MS held */
+    Test_Keypad_Feed(k5, (uint16_t)(TEST_LONG_TICKS - 1u));
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    Keypad_InjectScan(k5);
+    if ((Test_Keypad_Expect(KEYPAD_EV_LONG, '5', k5) == FALSE) ||
+        (Test_Keypad_QueueEmpty() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - then one REPEAT every KEYPAD_REPEAT_MS */
+    Test_Keypad_Feed(k5, (uint16_t)(TEST_REPEAT_TICKS - 1u));
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    Keypad_InjectScan(k5);
+    Test_Keypad_Feed(k5, (uint16_t)TEST_REPEAT_TICKS);
+    if ((Test_Keypad_Expect(KEYPAD_EV_REPEAT, '5', k5) == FALSE) ||
+        (Test_Keypad_Expect(KEYPAD_EV_REPEAT, '5', k5) == FALSE) ||
+        (Test_Keypad_QueueEmpty() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    /* Execute - a one-tick release bounce is still the same press */
+    Keypad_InjectScan(0u);
+    Keypad_InjectScan(k5);
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - RELEASE on the DEBOUNCE_TICKS-th tick up, nothing down after */
+    Test_Keypad_Feed(0u, (uint16_t)(TEST_DEBOUNCE_TICKS - 1u));
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    Keypad_InjectScan(0u);
+    if ((Test_Keypad_Expect(KEYPAD_EV_RELEASE, '5', 0u) == FALSE) ||
+        (Test_Keypad_QueueEmpty() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Keypad_Step_QueueFullDrops(void)
+{
+    boolean result = TRUE;
+    const uint16_t k1 = Keypad_KeyMask('1');
+    uint16_t dropped;
+    uint8_t i;
+    
+    /* Setup */
+    Keypad_Init();
+    dropped = Keypad_GetDroppedEvents();
+    
+    /* Execute - KEYPAD_EVENT_QUEUE_LEN events into room for one fewer */
+    for (i = 0u; i < (KEYPAD_EVENT_QUEUE_LEN / 2u); i++)
+    {
+        Test_Keypad_Feed(k1, (uint16_t)TEST_DEBOUNCE_TICKS);
+        Test_Keypad_Feed(0u, (uint16_t)TEST_DEBOUNCE_TICKS);
+    }
+    
+    if (Keypad_GetDroppedEvents() != (uint16_t)(dropped + 1u))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - the older events are kept in order, the last RELEASE lost */
+    for (i = 0u; i < (KEYPAD_EVENT_QUEUE_LEN - 1u); i++)
+    {
+        if ((i % 2u) == 0u)
+        {
+            if (Test_Keypad_Expect(KEYPAD_EV_PRESS, '1', k1) == FALSE)
+            {
+                result = FALSE;
+            }
+        }
+        else if (Test_Keypad_Expect(KEYPAD_EV_RELEASE, '1', 0u) == FALSE)
+        {
+            result = FALSE;
+        }
+        else { }
+    }
+    
+    if (Test_Keypad_QueueEmpty() == FALSE)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
 void Test_Keypad_RunAll(void)
 {
     TestLog_SuiteStart(KEYPAD_SUITE);
     
     TEST_RUN(KEYPAD_SUITE, "Init_ConfiguresGPIO", Test_Keypad_Init_ConfiguresGPIO);
     TEST_RUN(KEYPAD_SUITE, "Timeout_NoKey_ReturnsNotOK", Test_Keypad_Timeout_NoKey_ReturnsNotOK);
+    TEST_RUN(KEYPAD_SUITE, "Idle_RowsLowAndArmed", Test_Keypad_Idle_RowsLowAndArmed);
+    TEST_RUN(KEYPAD_SUITE, "Idle_PollIsFree", Test_Keypad_Idle_PollIsFree);
+    TEST_RUN(KEYPAD_SUITE, "SpuriousEdge_NoEvent", Test_Keypad_SpuriousEdge_NoEvent);
+    TEST_RUN(KEYPAD_SUITE, "Ghost_RectangleAmbiguous", Test_Keypad_Ghost_RectangleAmbiguous);
+    TEST_RUN(KEYPAD_SUITE, "TypeAhead_Overflow", Test_Keypad_TypeAhead_Overflow);
+    TEST_RUN(KEYPAD_SUITE, "TypeAhead_FlushVsKeep", Test_Keypad_TypeAhead_FlushVsKeep);
+    TEST_RUN(KEYPAD_SUITE, "Step_PressLongRepeatRelease", Test_Keypad_Step_PressLongRepeatRelease);
+    TEST_RUN(KEYPAD_SUITE, "Step_QueueFullDrops", Test_Keypad_Step_QueueFullDrops);
     
     TestLog_SuiteEnd(KEYPAD_SUITE);
 }
@@ -30,4 +30,58 @@ boolean Test_Keypad_Init_ConfiguresGPIO(void);
  */
 boolean Test_Keypad_Timeout_NoKey_ReturnsNotOK(void);
 
+/**
+ * @brief Test idle state: rows low, column edge interrupts armed
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_Idle_RowsLowAndArmed(void);
+
+/**
+ * @brief Test polls with no key down skip the matrix scan
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_Idle_PollIsFree(void);
+
+/**
+ * @brief Test an edge with no key down starts and stops the scan tick
+ *        without producing an event
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_SpuriousEdge_NoEvent(void);
+
+/**
+ * @brief Test a rectangle of keys is flagged as ambiguous while rows,
+ *        diagonals and the '*' + '#' chord are not
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_Ghost_RectangleAmbiguous(void);
+
+/**
+ * @brief Test the type-ahead keeps TYPEAHEAD_LEN presses in order, drops
+ *        the newest when full and skips stale ones
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_TypeAhead_Overflow(void);
+
+/**
+ * @brief Test TA_KEEP hands held presses on while TA_FLUSH drops them and
+ *        those typed inside its window
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_TypeAhead_FlushVsKeep(void);
+
+/**
+ * @brief Test a scripted raw-scan series through Keypad_InjectScan gives
+ *        PRESS after debounce, LONG, REPEAT and RELEASE, ignoring bounces
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_Step_PressLongRepeatRelease(void);
+
+/**
+ * @brief Test a full event queue keeps the older events and counts the
+ *        dropped one
+ * @return TRUE if passed
+ */
+boolean Test_Keypad_Step_QueueFullDrops(void);
+
 #endif /* TEST_CASES_DRIVER_KEYPAD_H */
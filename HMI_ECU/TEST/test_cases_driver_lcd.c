@@ -16,6 +16,53 @@
 #include "test_log.h"
 #include "../HAL/LCD.h"
 #include "../MCAL/Delay.h"
+#include "../MCAL/Clock.h"
+#include "../MCAL/Profile.h"
+
+/*===========================================================================*/
+/*                           TEST CONFIGURATION                              */
+/*===========================================================================*/
+
+/* Two full lines; one char per I2C burst should beat 200 chars/s
+ * (three transactions plus 4 ms of strobe delays per nibble managed ~96) */
+#define TEST_THROUGHPUT_CHARS     (32u)
+#define TEST_MIN_CHARS_PER_SEC    (200u)
+
+/* Clear needs 1.52 ms; polled, it must beat the 7 ms timed fallback */
+#define TEST_CLEAR_POLLED_MAX_MS  (4u)
+
+/* Full-screen flush is 204 expander bytes, ~19 ms at 100 kHz */
+#define TEST_FLUSH_DONE_MS        (50u)
+
+/* Full-screen refresh, 32 cells + 2 cursor moves: 204 expander bytes are
+ * 18.5 ms at the default 100 kHz (~4.6 ms with LCD_I2C_FAST); 34 timed
+ * writes are ~1.5 ms on GPIO4 and ~1.4 ms on GPIO8 */
+#if (LCD_BUS == LCD_BUS_I2C)
+#define TEST_REFRESH_BUS_NAME     "LCD bus: PCF8574/I2C"
+#define TEST_REFRESH_MAX_US       (25000u)
+#elif (LCD_BUS == LCD_BUS_GPIO4)
+#define TEST_REFRESH_BUS_NAME     "LCD bus: GPIO 4-bit"
+#define TEST_REFRESH_MAX_US       (2000u)
+#else
+#define TEST_REFRESH_BUS_NAME     "LCD bus: GPIO 8-bit"
+#define TEST_REFRESH_MAX_US       (2000u)
+#endif
+
+/* One more distinct glyph than there are CGRAM slots */
+#define TEST_GLYPH_COUNT          (LCD_CGRAM_SLOTS + 1u)
+
+static const uint8_t s_test_glyphs[TEST_GLYPH_COUNT][LCD_GLYPH_ROWS] =
+{
+    { 0x01u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x02u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x04u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x08u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x10u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x03u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x06u, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x0Cu, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+    { 0x18u, 0u, 0u, 0u, 0u, 0u, 0u, 0u }
+};
 
 /*===========================================================================*/
 /*                           TEST SUITE NAME                                 */
@@ -23,6 +70,45 @@
 
 #define LCD_SUITE         "LCD"
 
+/*===========================================================================*/
+/*                           HELPER FUNCTIONS                                */
+/*===========================================================================*/
+
+/* Flushes run in the background; let one finish before the next */
+static boolean Test_LCD_WaitFlush(void)
+{
+    uint32_t start = Delay_GetTicksMs();
+    
+    while (LCD_IsFlushPending() == TRUE)
+    {
+        if ((Delay_GetTicksMs() - start) >= TEST_FLUSH_DONE_MS)
+        {
+            return FALSE;
+        }
+    }
+    
+    return TRUE;
+}
+
+/* Flush until nothing is left, under whatever budget is set; a flush
+ * may carry only glyph uploads */
+static uint8_t Test_LCD_FlushAll(void)
+{
+    uint8_t total = 0u;
+    uint8_t sent;
+    uint16_t uploads;
+    
+    do
+    {
+        uploads = LCD_GetGlyphUploadCount();
+        sent = LCD_Flush();
+        total = (uint8_t)(total + sent);
+    } while (((sent > 0u) || (LCD_GetGlyphUploadCount() != uploads)) &&
+             (Test_LCD_WaitFlush() == TRUE));
+    
+    return total;
+}
+
 /*===========================================================================*/
 /*                           TEST IMPLEMENTATIONS                            */
 /*===========================================================================*/
@@ -109,6 +195,410 @@ boolean Test_LCD_SendString_SmokeTest(void)
     return result;
 }
 
+boolean Test_LCD_Flush_OnlyDirtyCells(void)
+{
+    boolean result = TRUE;
+    
+    /* Setup */
+    LCD_Init();
+    
+    /* Execute & Verify - first flush sends the text, not the padding */
+    LCD_BufWriteLine(0u, "Flush-test");
+    if ((LCD_Flush() != 10u) || (Test_LCD_WaitFlush() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    /* One changed character costs one cell */
+    LCD_BufWriteLine(0u, "Flush-best");
+    if ((LCD_Flush() != 1u) || (Test_LCD_WaitFlush() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    /* Nothing changed, nothing sent */
+    if (LCD_Flush() != 0u)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_LCD_DirectWrite_SyncsBuffer(void)
+{
+    boolean result = TRUE;
+    
+    /* Setup */
+    LCD_Init();
+    
+    /* Execute - direct writes after a buffered screen */
+    LCD_BufWriteLine(1u, "old");
+    (void)LCD_Flush();
+    LCD_Clear();
+    LCD_SetCursor(1u, 0u);
+    LCD_SendString("new");
+    
+    /* Verify - the buffer followed, so a flush has nothing to repaint */
+    if (LCD_Flush() != 0u)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_LCD_Throughput_CharsPerSec(void)
+{
+    boolean result = TRUE;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t cps;
+    uint8_t i;
+    
+    /* Setup */
+    LCD_Init();
+    LCD_SetCursor(0u, 0u);
+    
+    /* Execute */
+    start = Delay_GetTicksMs();
+    for (i = 0u; i < TEST_THROUGHPUT_CHARS; i++)
+    {
+        if (i == LCD_COLS)
+        {
+            LCD_SetCursor(1u, 0u);
+        }
+        LCD_SendChar((char)('A' + (char)(i % 26u)));
+    }
+    elapsed = Delay_GetTicksMs() - start;
+    
+    /* Verify */
+    cps = (elapsed > 0u) ? ((TEST_THROUGHPUT_CHARS * 1000u) / elapsed) : 0u;
+    TestLog_InfoNumeric("LCD chars/s: ", cps);
+    
+    if (cps < TEST_MIN_CHARS_PER_SEC)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_LCD_Clear_WaitsOnBusyFlag(void)
+{
+    boolean result = TRUE;
+    uint32_t start;
+    uint32_t elapsed;
+    
+    /* Setup */
+    LCD_Init();
+    LCD_SendString("Busy");
+    
+    /* Execute */
+    start = Delay_GetTicksMs();
+    LCD_Clear();
+    elapsed = Delay_GetTicksMs() - start;
+    
+    /* Verify - a backpack without RW wired falls back to timed waits */
+    TestLog_InfoNumeric("LCD clear ms: ", elapsed);
+    
+    if (LCD_IsBusyPollActive() == FALSE)
+    {
+        TestLog_Info("LCD busy flag unreadable, timed waits in use");
+    }
+    else if (elapsed > TEST_CLEAR_POLLED_MAX_MS)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_LCD_Flush_RunsInBackground(void)
+{
+    boolean result = TRUE;
+    uint32_t start;
+    uint32_t elapsed;
+    
+    /* Setup - no budget, so the whole screen is one transaction */
+    LCD_Init();
+    LCD_SetFlushBudget(0u, 0u);
+    
+    /* Execute - a full redraw only has to be queued */
+    LCD_BufWriteLine(0u, "Background-flush");
+    LCD_BufWriteLine(1u, "0123456789ABCDEF");
+    start = Delay_GetTicksMs();
+    if (LCD_Flush() != (LCD_ROWS * LCD_COLS))
+    {
+        result = FALSE;
+    }
+    elapsed = Delay_GetTicksMs() - start;
+    
+    /* Verify - returned at once, busy meanwhile, done later. The GPIO
+     * buses have no background engine and return when done instead. */
+    TestLog_InfoNumeric("LCD flush call ms: ", elapsed);
+#if (LCD_BUS == LCD_BUS_I2C)
+    if (elapsed > 1u)
+    {
+        result = FALSE;
+    }
+#endif
+    
+    if (LCD_Flush() != 0u)
+    {
+        result = FALSE;
+    }
+    
+    if (Test_LCD_WaitFlush() == FALSE)
+    {
+        TestLog_Info("LCD flush did not complete");
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    LCD_SetFlushBudget(LCD_FLUSH_BUDGET_DEFAULT, 0u);
+    
+    return result;
+}
+
+boolean Test_LCD_Glyph_LruCache(void)
+{
+    boolean result = TRUE;
+    uint16_t uploads;
+    char first;
+    char code;
+    char line[LCD_CGRAM_SLOTS + 1u];
+    uint8_t i;
+    
+    /* Setup - LCD_Init empties the cache */
+    LCD_Init();
+    uploads = LCD_GetGlyphUploadCount();
+    
+    /* Execute - a repeat draw is a hit; nothing goes out before the flush */
+    first = LCD_Glyph(s_test_glyphs[0]);
+    if ((LCD_Glyph(s_test_glyphs[0]) != first) ||
+        (LCD_GetGlyphUploadCount() != uploads))
+    {
+        result = FALSE;
+    }
+    
+    if ((Test_LCD_FlushAll() != 0u) ||
+        ((uint16_t)(LCD_GetGlyphUploadCount() - uploads) != 1u))
+    {
+        result = FALSE;
+    }
+    
+    /* Fill the other slots; codes stay in 8..15 */
+    for (i = 1u; i < LCD_CGRAM_SLOTS; i++)
+    {
+        code = LCD_Glyph(s_test_glyphs[i]);
+        if ((code < (char)0x08) || (code > (char)0x0F))
+        {
+            result = FALSE;
+        }
+    }
+    
+    /* Ninth glyph evicts the least recently drawn: glyph 0 */
+    if (LCD_Glyph(s_test_glyphs[LCD_CGRAM_SLOTS]) != first)
+    {
+        result = FALSE;
+    }
+    (void)Test_LCD_FlushAll();
+    
+    /* Verify - glyph 1 is still cached, glyph 0 has to come back */
+    uploads = LCD_GetGlyphUploadCount();
+    (void)LCD_Glyph(s_test_glyphs[1]);
+    (void)Test_LCD_FlushAll();
+    if (LCD_GetGlyphUploadCount() != uploads)
+    {
+        result = FALSE;
+    }
+    
+    (void)LCD_Glyph(s_test_glyphs[0]);
+    (void)Test_LCD_FlushAll();
+    if (LCD_GetGlyphUploadCount() == uploads)
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - with every slot on screen a miss is refused, not evicted */
+    for (i = 0u; i < LCD_CGRAM_SLOTS; i++)
+    {
+        line[i] = LCD_Glyph(s_test_glyphs[i]);
+    }
+    line[LCD_CGRAM_SLOTS] = '\0';
+    LCD_BufWriteLine(0u, line);
+    (void)Test_LCD_FlushAll();
+    
+    uploads = LCD_GetGlyphUploadCount();
+    if ((LCD_Glyph(s_test_glyphs[LCD_CGRAM_SLOTS]) != ' ') ||
+        (Test_LCD_FlushAll() != 0u) ||
+        (LCD_GetGlyphUploadCount() != uploads))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_LCD_ProgressBar_OnlyChangedCells(void)
+{
+    boolean result = TRUE;
+    
+    /* Setup */
+    LCD_Init();
+    LCD_BufProgressBar(1u, 0u, LCD_COLS, 10u, 10u);
+    if (Test_LCD_FlushAll() != LCD_COLS)
+    {
+        result = FALSE;
+    }
+    
+    /* Execute - 72 of 80 columns: cell 14 drops to a 2/5 glyph, 15 blanks */
+    LCD_BufProgressBar(1u, 0u, LCD_COLS, 9u, 10u);
+    
+    /* Verify */
+    if (Test_LCD_FlushAll() != 2u)
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_LCD_Flush_BudgetResumes(void)
+{
+    boolean result = TRUE;
+    
+    /* Setup - 4 cells in a run, or a cursor move + 3 cells */
+    LCD_Init();
+    LCD_SetFlushBudget((uint16_t)(4u * LCD_CELL_BUS_BYTES), 0u);
+    LCD_BufWriteLine(0u, "Trickle-out-line");
+    
+    /* Execute & Verify - each pass resumes where the last stopped */
+    if ((LCD_Flush() != 4u) || (Test_LCD_WaitFlush() == FALSE))
+    {
+        result = FALSE;
+    }
+    
+    if (Test_LCD_FlushAll() != (LCD_COLS - 4u))
+    {
+        result = FALSE;
+    }
+    
+    /* Away from the cursor the move eats into the budget */
+    LCD_BufWriteLine(1u, "abcd");
+    if ((LCD_Flush() != 3u) || (Test_LCD_FlushAll() != 1u))
+    {
+        result = FALSE;
+    }
+    
+    /* A time cap below one cell still sends one cell */
+    LCD_SetFlushBudget(0u, 10u);
+    LCD_BufWriteLine(1u, "abxy");
+    if ((LCD_Flush() != 1u) || (Test_LCD_FlushAll() != 1u))
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    LCD_SetFlushBudget(LCD_FLUSH_BUDGET_DEFAULT, 0u);
+    
+    return result;
+}
+
+boolean Test_LCD_Backlight_Piggyback(void)
+{
+    boolean result = TRUE;
+    
+    /* Setup */
+    LCD_Init();
+    (void)Test_LCD_FlushAll();
+    
+    /* Execute - off with nothing to draw: a lone byte after the grace time */
+    LCD_SetBacklight(FALSE);
+    if ((LCD_GetBacklight() != FALSE) || (LCD_Flush() != 0u) ||
+        (LCD_IsFlushPending() == TRUE))
+    {
+        result = FALSE;
+    }
+    
+    Delay_ms(25u);
+    (void)LCD_Flush();
+#if (LCD_BUS == LCD_BUS_I2C)
+    /* The byte went out on its own; GPIO buses switch the pin at once */
+    if (LCD_IsFlushPending() == FALSE)
+    {
+        result = FALSE;
+    }
+#endif
+    if (Test_LCD_WaitFlush() == FALSE)
+    {
+        result = FALSE;
+    }
+    
+    /* Sent once: nothing left to carry */
+    (void)LCD_Flush();
+    if (LCD_IsFlushPending() == TRUE)
+    {
+        result = FALSE;
+    }
+    
+    /* Back on with text pending: carried by the cells, none extra */
+    LCD_SetBacklight(TRUE);
+    LCD_BufWriteLine(0u, "Lit");
+    if ((LCD_GetBacklight() == FALSE) || (Test_LCD_FlushAll() != 3u))
+    {
+        result = FALSE;
+    }
+    
+    /* Verify - visual: backlight went off for ~25 ms and came back */
+    return result;
+}
+
+boolean Test_LCD_Benchmark_FullRefresh(void)
+{
+    boolean result = TRUE;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t us;
+    
+    /* Setup - no budget, and a screen every cell of the next one differs from */
+    LCD_Init();
+    LCD_SetFlushBudget(0u, 0u);
+    LCD_BufWriteLine(0u, "abcdefghijklmnop");
+    LCD_BufWriteLine(1u, "qrstuvwxyzabcdef");
+    (void)Test_LCD_FlushAll();
+    
+    /* Execute - from the call until the last cell is on the panel */
+    LCD_BufWriteLine(0u, "ABCDEFGHIJKLMNOP");
+    LCD_BufWriteLine(1u, "QRSTUVWXYZABCDEF");
+    start = Profile_GetCycles();
+    if (LCD_Flush() != (LCD_ROWS * LCD_COLS))
+    {
+        result = FALSE;
+    }
+    if (Test_LCD_WaitFlush() == FALSE)
+    {
+        result = FALSE;
+    }
+    cycles = Profile_GetCycles() - start;
+    
+    /* Verify - run once per LCD_BUS build and compare the logged times */
+    us = cycles / (Clock_GetSysClkHz() / 1000000u);
+    TestLog_Info(TEST_REFRESH_BUS_NAME);
+    TestLog_InfoNumeric("LCD full refresh us: ", us);
+    
+    if (us > TEST_REFRESH_MAX_US)
+    {
+        result = FALSE;
+    }
+    
+    /* Cleanup */
+    LCD_SetFlushBudget(LCD_FLUSH_BUDGET_DEFAULT, 0u);
+    
+    return result;
+}
+
 void Test_LCD_RunAll(void)
 {
     TestLog_SuiteStart(LCD_SUITE);
@@ -117,6 +607,16 @@ void Test_LCD_RunAll(void)
     TEST_RUN(LCD_SUITE, "Clear_Works", Test_LCD_Clear_Works);
     TEST_RUN(LCD_SUITE, "SetCursor_Works", Test_LCD_SetCursor_Works);
     TEST_RUN(LCD_SUITE, "SendString_SmokeTest", Test_LCD_SendString_SmokeTest);
+    TEST_RUN(LCD_SUITE, "Flush_OnlyDirtyCells", Test_LCD_Flush_OnlyDirtyCells);
+    TEST_RUN(LCD_SUITE, "DirectWrite_SyncsBuffer", Test_LCD_DirectWrite_SyncsBuffer);
+    TEST_RUN(LCD_SUITE, "Throughput_CharsPerSec", Test_LCD_Throughput_CharsPerSec);
+    TEST_RUN(LCD_SUITE, "Clear_WaitsOnBusyFlag", Test_LCD_Clear_WaitsOnBusyFlag);
+    TEST_RUN(LCD_SUITE, "Flush_RunsInBackground", Test_LCD_Flush_RunsInBackground);
+    TEST_RUN(LCD_SUITE, "Glyph_LruCache", Test_LCD_Glyph_LruCache);
+    TEST_RUN(LCD_SUITE, "ProgressBar_OnlyChangedCells", Test_LCD_ProgressBar_OnlyChangedCells);
+    TEST_RUN(LCD_SUITE, "Flush_BudgetResumes", Test_LCD_Flush_BudgetResumes);
+    TEST_RUN(LCD_SUITE, "Backlight_Piggyback", Test_LCD_Backlight_Piggyback);
+    TEST_RUN(LCD_SUITE, "Benchmark_FullRefresh", Test_LCD_Benchmark_FullRefresh);
     
     TestLog_SuiteEnd(LCD_SUITE);
 }
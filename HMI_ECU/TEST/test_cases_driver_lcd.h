@@ -42,4 +42,64 @@ boolean Test_LCD_SetCursor_Works(void);
  */
 boolean Test_LCD_SendString_SmokeTest(void);
 
+/**
+ * @brief Test LCD_Flush() sends only cells that changed
+ * @return TRUE if passed
+ */
+boolean Test_LCD_Flush_OnlyDirtyCells(void);
+
+/**
+ * @brief Test direct LCD writes keep the shadow buffer in sync
+ * @return TRUE if passed
+ */
+boolean Test_LCD_DirectWrite_SyncsBuffer(void);
+
+/**
+ * @brief Measure LCD_SendChar throughput and log chars/s
+ * @return TRUE if above the minimum rate
+ */
+boolean Test_LCD_Throughput_CharsPerSec(void);
+
+/**
+ * @brief Time LCD_Clear with busy-flag polling against the timed fallback
+ * @return TRUE if polled clear is fast, or fallback is in use
+ */
+boolean Test_LCD_Clear_WaitsOnBusyFlag(void);
+
+/**
+ * @brief Verify LCD_Flush queues a full redraw and returns before it is sent
+ * @return TRUE if passed
+ */
+boolean Test_LCD_Flush_RunsInBackground(void);
+
+/**
+ * @brief Verify CGRAM glyphs upload once and the LRU slot is evicted
+ * @return TRUE if passed
+ */
+boolean Test_LCD_Glyph_LruCache(void);
+
+/**
+ * @brief Verify a one-step progress bar change flushes only the changed cells
+ * @return TRUE if passed
+ */
+boolean Test_LCD_ProgressBar_OnlyChangedCells(void);
+
+/**
+ * @brief Verify a byte/time flush budget splits a redraw and resumes in place
+ * @return TRUE if passed
+ */
+boolean Test_LCD_Flush_BudgetResumes(void);
+
+/**
+ * @brief Verify backlight changes ride on data writes or go out as one byte
+ * @return TRUE if passed
+ */
+boolean Test_LCD_Backlight_Piggyback(void);
+
+/**
+ * @brief Time a full-screen refresh on the LCD_BUS this build uses
+ * @return TRUE if passed
+ */
+boolean Test_LCD_Benchmark_FullRefresh(void);
+
 #endif /* TEST_CASES_DRIVER_LCD_H */
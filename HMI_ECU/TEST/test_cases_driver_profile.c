@@ -0,0 +1,132 @@
+/**
+ * @file    test_cases_driver_profile.c
+ * @brief   Profiling Zone Unit Tests Implementation - HMI ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * @details Tests the DWT cycle counter and per-zone statistics.
+ *          Ends with Profile_Reset(), so the dump in test_main only
+ *          covers the suites that run after this one.
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#include "test_cases_driver_profile.h"
+#include "test_config.h"
+#include "test_log.h"
+#include "../MCAL/Profile.h"
+#include "../MCAL/Clock.h"
+#include "../MCAL/Delay.h"
+
+/*===========================================================================*/
+/*                           TEST CONFIGURATION                              */
+/*===========================================================================*/
+
+/* Zone borrowed for the tests */
+#define TEST_ZONE                 (PROF_ZONE_LCD_SENDCHAR)
+
+/* Measured section length */
+#define TEST_SECTION_MS           (2u)
+
+/*===========================================================================*/
+/*                           TEST SUITE NAME                                 */
+/*===========================================================================*/
+
+#define PROFILE_SUITE     "Profile"
+
+/*===========================================================================*/
+/*                           TEST IMPLEMENTATIONS                            */
+/*===========================================================================*/
+
+boolean Test_Profile_CycleCounter_Runs(void)
+{
+    boolean result = TRUE;
+    uint32_t before;
+    uint32_t after;
+    
+    /* Execute */
+    before = Profile_GetCycles();
+    Delay_ms(1u);
+    after = Profile_GetCycles();
+    
+    /* Verify counter moved by roughly one millisecond of cycles */
+    if ((after - before) < (Clock_GetSysClkHz() / 2000u))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+boolean Test_Profile_Zone_RecordsStats(void)
+{
+    boolean result = TRUE;
+    const Profile_ZoneStats *z;
+    uint32_t minExpected;
+    
+    /* Setup */
+    Profile_Reset();
+    minExpected = (Clock_GetSysClkHz() / 1000u) * (TEST_SECTION_MS - 1u);
+    
+    /* Execute - two measured sections */
+    Profile_Begin(TEST_ZONE);
+    Delay_ms(TEST_SECTION_MS);
+    Profile_End(TEST_ZONE);
+    
+    Profile_Begin(TEST_ZONE);
+    Delay_ms(TEST_SECTION_MS);
+    Profile_End(TEST_ZONE);
+    
+    /* Verify */
+    z = Profile_GetZone(TEST_ZONE);
+    
+    if ((z == (const Profile_ZoneStats *)0) || (z->count != 2u))
+    {
+        result = FALSE;
+    }
+    else if ((z->min_cycles < minExpected) || (z->min_cycles > z->max_cycles))
+    {
+        result = FALSE;
+    }
+    else if (z->total_cycles < (z->min_cycles + z->max_cycles))
+    {
+        result = FALSE;
+    }
+    else
+    {
+        /* passed */
+    }
+    
+    return result;
+}
+
+boolean Test_Profile_Reset_ClearsZones(void)
+{
+    boolean result = TRUE;
+    const Profile_ZoneStats *z;
+    
+    /* Execute */
+    Profile_Reset();
+    
+    /* Verify */
+    z = Profile_GetZone(TEST_ZONE);
+    
+    if ((z->count != 0u) || (z->max_cycles != 0u) || (z->total_cycles != 0u))
+    {
+        result = FALSE;
+    }
+    
+    return result;
+}
+
+void Test_Profile_RunAll(void)
+{
+    TestLog_SuiteStart(PROFILE_SUITE);
+    
+    TEST_RUN(PROFILE_SUITE, "CycleCounter_Runs", Test_Profile_CycleCounter_Runs);
+    TEST_RUN(PROFILE_SUITE, "Zone_RecordsStats", Test_Profile_Zone_RecordsStats);
+    TEST_RUN(PROFILE_SUITE, "Reset_ClearsZones", Test_Profile_Reset_ClearsZones);
+    
+    TestLog_SuiteEnd(PROFILE_SUITE);
+}
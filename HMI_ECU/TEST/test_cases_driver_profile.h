@@ -0,0 +1,39 @@
+/**
+ * @file    test_cases_driver_profile.h
+ * @brief   Profiling Zone Unit Tests - HMI ECU
+ * @project Embedded Door-Lock System
+ * @target  TM4C123GH6PM
+ * @version 1.0
+ * 
+ * MISRA-C:2012 Compliant
+ */
+
+#ifndef TEST_CASES_DRIVER_PROFILE_H
+#define TEST_CASES_DRIVER_PROFILE_H
+
+#include "../Common/Std_Types.h"
+
+/**
+ * @brief Run all Profile unit tests
+ */
+void Test_Profile_RunAll(void);
+
+/**
+ * @brief Test DWT cycle counter advances
+ * @return TRUE if passed
+ */
+boolean Test_Profile_CycleCounter_Runs(void);
+
+/**
+ * @brief Test a zone records count, min, max and total
+ * @return TRUE if passed
+ */
+boolean Test_Profile_Zone_RecordsStats(void);
+
+/**
+ * @brief Test reset clears all zones
+ * @return TRUE if passed
+ */
+boolean Test_Profile_Reset_ClearsZones(void);
+
+#endif /* TEST_CASES_DRIVER_PROFILE_H */
@@ -21,6 +21,7 @@
 #include "../MCAL/UART.h"
 #include "../MCAL/ADC.h"
 #include "../MCAL/Delay.h"
+#include "../APP/LockoutTimer.h"
 
 /*===========================================================================*/
 /*                           PROTOCOL DEFINITIONS                            */
@@ -515,7 +516,8 @@ boolean Test_Sys_Lockout_Duration(void)
     uint8_t response = 0u;
     Std_ReturnType retVal;
     const char correctPassword[PASSWORD_LENGTH] = {'1', '2', '3', '4', '5'};
-    uint32_t lockoutDurationMs = 60000u;  /* 60 seconds typical lockout */
+    const uint32_t lockoutDurationMs = (uint32_t)LOCKOUT_SEC * 1000u;
+    LockoutTimer lock;
     
     TestLog_Info("Scenario: Lockout duration test");
     TestLog_Info("Waiting for lockout to expire...");
@@ -525,10 +527,26 @@ boolean Test_Sys_Lockout_Duration(void)
     LCD_SetCursor(0u, 0u);
     LCD_SendString("Lockout wait");
     LCD_SetCursor(1u, 0u);
-    LCD_SendString("60 seconds...");
+    LCD_SendString("until unlocked");
     
-    /* Wait for lockout to expire */
-    Delay_ms(lockoutDurationMs + 5000u);  /* Add 5 second buffer */
+    /* Wait for lockout to expire, counted in SysTick milliseconds:
+     * still locked 1 ms before the deadline, open exactly at it */
+    LockoutTimer_Start(&lock, LOCKOUT_SEC);
+    Delay_ms(lockoutDurationMs - 1u);
+    
+    if ((LockoutTimer_IsLocked(&lock) != TRUE) || (LockoutTimer_SecondsLeft(&lock) != 1u))
+    {
+        TestLog_Info("Lockout ended early");
+        result = FALSE;
+    }
+    
+    Delay_ms(1u);
+    
+    if ((LockoutTimer_IsLocked(&lock) != FALSE) || (LockoutTimer_SecondsLeft(&lock) != 0u))
+    {
+        TestLog_Info("Lockout still active at its deadline");
+        result = FALSE;
+    }
     
     /* Try correct password after lockout */
     UART1_FlushRx();
@@ -43,6 +43,8 @@
 #define TEST_UNIT_LCD                   (1u)
 #define TEST_UNIT_KEYPAD                (1u)
 #define TEST_UNIT_BUZZER                (1u)
+#define TEST_UNIT_CLOCK                 (1u)
+#define TEST_UNIT_PROFILE               (1u)
 
 /*===========================================================================*/
 /*                       INTEGRATION TEST SELECTION                          */
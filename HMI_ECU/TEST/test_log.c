@@ -91,7 +91,7 @@ Std_ReturnType TestLog_Init(void)
     if (g_initialized == FALSE)
     {
         UART1_Init(TEST_LOG_UART_BAUDRATE);
-        Delay_Init_16MHz();
+        Delay_Init();
         
         g_testStats.total_tests = 0u;
         g_testStats.passed      = 0u;
@@ -265,6 +265,24 @@ void TestLog_Info(const char *message)
     PrintNewline();
 }
 
+void TestLog_InfoNumeric(const char *message, uint32_t value)
+{
+    char valStr[12];
+    
+    if (message == NULL)
+    {
+        return;
+    }
+    
+    UInt32ToString(value, valStr);
+    
+    PrintTimestamp();
+    UART1_SendString("[INFO] ");
+    UART1_SendString(message);
+    UART1_SendString(valStr);
+    PrintNewline();
+}
+
 void TestLog_Print(const char *str)
 {
     if (str == NULL)
@@ -111,6 +111,13 @@ void TestLog_SuiteEnd(const char *suiteName);
  */
 void TestLog_Info(const char *message);
 
+/**
+ * @brief Log informational message followed by a number
+ * @param message Info message
+ * @param value   Value printed after the message
+ */
+void TestLog_InfoNumeric(const char *message, uint32_t value);
+
 /**
  * @brief Print raw string to log
  * @param str String to print
@@ -22,6 +22,7 @@
 
 /* MCAL includes for hardware init */
 #include "../MCAL/Delay.h"
+#include "../MCAL/Profile.h"
 #include "../MCAL/UART.h"
 #include "../HAL/LCD.h"
 
@@ -39,7 +40,8 @@ int main(void)
     const TestStats_t *stats;
     
     /* Initialize hardware */
-    Delay_Init_16MHz();
+    Delay_Init();
+    Profile_Init();
     
     /* Initialize test framework */
     (void)TestRunner_Init();
@@ -55,6 +57,10 @@ int main(void)
     /* Run all tests */
     failedTests = TestRunner_RunAll();
     
+    /* Cycle counts collected by the instrumented drivers */
+    TestLog_Info("Profile zones (cycles):");
+    Profile_Dump(TestLog_Print);
+    
     /* Get final statistics */
     stats = TestLog_GetStats();
     
@@ -24,6 +24,8 @@
 #include "test_cases_driver_lcd.h"
 #include "test_cases_driver_keypad.h"
 #include "test_cases_driver_buzzer.h"
+#include "test_cases_driver_clock.h"
+#include "test_cases_driver_profile.h"
 #include "test_cases_integration.h"
 #include "test_cases_system.h"
 
@@ -133,6 +135,22 @@ uint16_t TestRunner_RunUnitTests(void)
     failed += (stats->failed - prev_failed);
 #endif
 
+#if (TEST_UNIT_CLOCK == 1u)
+    stats = TestLog_GetStats();
+    prev_failed = stats->failed;
+    Test_Clock_RunAll();
+    stats = TestLog_GetStats();
+    failed += (stats->failed - prev_failed);
+#endif
+
+#if (TEST_UNIT_PROFILE == 1u)
+    stats = TestLog_GetStats();
+    prev_failed = stats->failed;
+    Test_Profile_RunAll();
+    stats = TestLog_GetStats();
+    failed += (stats->failed - prev_failed);
+#endif
+
 #else
     TestLog_Info("Unit tests disabled in configuration");
     (void)stats;